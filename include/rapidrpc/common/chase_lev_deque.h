@@ -0,0 +1,146 @@
+/**
+ * @file chase_lev_deque.h
+ * 无锁的工作窃取双端队列(Chase-Lev deque), 内存序参考 Lê et al. "Correct and Efficient Work-Stealing for Weak
+ * Memory Models"(PPoPP 2013)
+ * 只有所有者线程可以 push/take(在队尾，后进先出)，其他线程 steal(在队首，先进先出)
+ * 队列满时所有者线程将数组扩容为两倍, 旧数组在析构时释放(窃取者可能还在读取)
+ */
+
+#ifndef RAPIDRPC_COMMON_CHASE_LEV_DEQUE_H
+#define RAPIDRPC_COMMON_CHASE_LEV_DEQUE_H
+
+#include <atomic>
+#include <memory>
+#include <stdint.h>
+#include <vector>
+
+namespace rapidrpc {
+
+/**
+ * @brief 元素为 T*, 由使用者负责分配和释放
+ */
+template <typename T>
+class ChaseLevDeque {
+public:
+    explicit ChaseLevDeque(int64_t capacity = 256) {
+        int64_t size = 1;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        m_arrays.emplace_back(new Array(size));
+        m_array.store(m_arrays.back().get(), std::memory_order_relaxed);
+    }
+
+    ChaseLevDeque(const ChaseLevDeque &) = delete;
+    ChaseLevDeque &operator=(const ChaseLevDeque &) = delete;
+
+    /**
+     * @brief 添加到队尾, 只能由所有者线程调用
+     */
+    void push(T *item) {
+        int64_t b = m_bottom.load(std::memory_order_relaxed);
+        int64_t t = m_top.load(std::memory_order_acquire);
+        Array *array = m_array.load(std::memory_order_relaxed);
+        if (b - t > array->m_size - 1) {
+            array = grow(array, t, b);
+        }
+        array->put(b, item);
+        std::atomic_thread_fence(std::memory_order_release);
+        m_bottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 从队尾取出, 只能由所有者线程调用
+     * @return 队列为空(或者最后一个元素被窃取)时返回 nullptr
+     */
+    T *take() {
+        int64_t b = m_bottom.load(std::memory_order_relaxed) - 1;
+        Array *array = m_array.load(std::memory_order_relaxed);
+        m_bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = m_top.load(std::memory_order_relaxed);
+
+        T *item = nullptr;
+        if (t <= b) {
+            item = array->get(b);
+            if (t == b) {
+                // 最后一个元素, 与窃取者竞争
+                if (!m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                    item = nullptr;
+                }
+                m_bottom.store(b + 1, std::memory_order_relaxed);
+            }
+        }
+        else {
+            m_bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return item;
+    }
+
+    /**
+     * @brief 从队首窃取, 任意线程调用
+     * @return 队列为空，或者与其他线程竞争失败时返回 nullptr
+     */
+    T *steal() {
+        int64_t t = m_top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = m_bottom.load(std::memory_order_acquire);
+        if (t >= b) {
+            return nullptr;
+        }
+        Array *array = m_array.load(std::memory_order_acquire);
+        T *item = array->get(t);
+        if (!m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return item;
+    }
+
+    // 近似的元素个数
+    int64_t size() const {
+        int64_t b = m_bottom.load(std::memory_order_relaxed);
+        int64_t t = m_top.load(std::memory_order_relaxed);
+        return b > t ? b - t : 0;
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+private:
+    struct Array {
+        explicit Array(int64_t size) : m_size(size), m_mask(size - 1), m_items(new std::atomic<T *>[size]) {}
+
+        T *get(int64_t i) const {
+            return m_items[i & m_mask].load(std::memory_order_relaxed);
+        }
+
+        void put(int64_t i, T *item) {
+            m_items[i & m_mask].store(item, std::memory_order_relaxed);
+        }
+
+        int64_t m_size;
+        int64_t m_mask;
+        std::unique_ptr<std::atomic<T *>[]> m_items;
+    };
+
+    Array *grow(Array *array, int64_t t, int64_t b) {
+        Array *bigger = new Array(array->m_size * 2);
+        for (int64_t i = t; i < b; i++) {
+            bigger->put(i, array->get(i));
+        }
+        m_arrays.emplace_back(bigger);
+        m_array.store(bigger, std::memory_order_release);
+        return bigger;
+    }
+
+private:
+    alignas(64) std::atomic<int64_t> m_top{0};    // 窃取者修改
+    alignas(64) std::atomic<int64_t> m_bottom{0}; // 所有者修改
+    std::atomic<Array *> m_array{nullptr};
+    std::vector<std::unique_ptr<Array>> m_arrays; // 包括扩容前的数组, 只有所有者线程修改
+};
+
+} // namespace rapidrpc
+
+#endif // RAPIDRPC_COMMON_CHASE_LEV_DEQUE_H
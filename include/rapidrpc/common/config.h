@@ -35,6 +35,41 @@ public:
     std::string m_ip;
     int m_port;
     int m_io_threads;
+    std::string m_io_thread_placement; // 新连接选择 IO 线程的策略(IOThreadPlacement), 默认 round_robin
+    std::string m_accept_mode;         // main(主线程 accept), reuseport/reuseport_cbpf(每个 IO 线程 accept)
+    int m_accept_batch;                // 每次可读事件最多 accept 的连接数
+    int m_listen_backlog;              // listen 的 backlog(不超过 net.core.somaxconn)
+
+    // 运行时调整 IO 线程数(只支持 accept_mode 为 main)
+    int m_io_autoscale_interval_ms;   // 按繁忙比例自动调整的检查间隔(ms), 0 不自动调整
+    int m_io_threads_min;             // 自动调整的最少线程数
+    int m_io_threads_max;             // 自动调整的最多线程数, 0 使用 io_threads
+    int m_io_autoscale_high_permille; // 平均繁忙比例高于该值时增加线程
+    int m_io_autoscale_low_permille;  // 平均繁忙比例低于该值时排空线程
+    int m_io_drain_timeout_ms;        // 排空超过该时间后关闭剩余的连接(ms), 0 等待连接自己关闭
+
+    // 绑定 CPU 列表(例如 "0-3,8-11"), 空不绑定; 绑定的线程的内存优先分配在本地 NUMA 节点
+    std::string m_io_thread_cpus;   // 第 i 个 IO 线程绑定到列表中第 i % n 个 CPU
+    std::string m_main_thread_cpus; // 主线程(accept 的 EventLoop)绑定到列表中的所有 CPU
+
+    std::string m_poller_type; // IO 多路复用: epoll(默认) 或者 io_uring
+
+    int m_busy_poll_us;    // IO 线程阻塞前的最大自旋时间(us), 0 关闭
+    int m_so_busy_poll_us; // 新连接设置 SO_BUSY_POLL(us), 0 不设置
+
+    // 每轮循环的工作预算，超出的工作留到下一轮，避免单个连接/大量任务阻塞同一 IO 线程上的其他连接; 0 不限制
+    int m_loop_max_tasks;   // 每轮循环最多执行的任务数
+    int m_loop_max_task_us; // 每轮循环执行任务的最长时间(us)
+    int m_conn_read_budget; // 每个连接每次可读事件最多读取的字节数
+
+    // 业务线程池: 配置的服务在线程池中执行，IO 线程只负责读写和编解码
+    int m_worker_threads;           // 业务线程数, 0 不创建(所有服务在 IO 线程中执行)
+    int m_worker_queue_size;        // 等待执行的请求数上限, 超出时返回 SYS_SERVER_BUSY, 0 不限制
+    std::string m_pooled_services;  // 在业务线程池中执行的服务名, 逗号分隔, "*" 表示所有服务
+    std::string m_worker_scheduler; // 业务线程池类型: queue, work_stealing
+
+    int m_timer_wheel_tick_ms; // 定时器使用分层时间轮的 tick(ms), 0 使用 std::multimap
+    int m_timer_slack_us;      // 定时器允许的延迟(us), 窗口内的到达时间共用一次 timerfd 唤醒, 0 不延迟
 
     LogType m_log_type;
 };
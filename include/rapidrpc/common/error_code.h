@@ -28,6 +28,8 @@ enum class Error {
     SYS_FAILED_PARSE_SERVICE_NAME = SYS_ERROR_PREFIX(0010), // 解析服务名失败
 
     SYS_CHANNEL_NOT_INIT = SYS_ERROR_PREFIX(0011), // channel 未初始化
+
+    SYS_SERVER_BUSY = SYS_ERROR_PREFIX(0012), // 服务端业务线程池队列已满
 };
 }
 
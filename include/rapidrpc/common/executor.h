@@ -0,0 +1,55 @@
+/**
+ * @file executor.h
+ * 业务线程池的公共接口, Dispatcher 通过它把 pooled 服务的请求交给业务线程执行
+ * 实现: WorkerPool(所有线程共享一个有界队列), WorkStealingPool(每个线程一个 Chase-Lev 双端队列, 空闲时窃取)
+ */
+
+#ifndef RAPIDRPC_COMMON_EXECUTOR_H
+#define RAPIDRPC_COMMON_EXECUTOR_H
+
+#include "rapidrpc/common/inline_function.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+namespace rapidrpc {
+
+class Executor {
+public:
+    virtual ~Executor() {}
+
+    /**
+     * @brief 添加任务, 可以在任意线程调用
+     * @return false: 队列已满或者已经停止, 任务没有被添加
+     */
+    virtual bool submit(Task task) = 0;
+
+    /**
+     * @brief 停止并等待所有线程结束, 队列中剩余的任务会先执行完
+     */
+    virtual void stop() = 0;
+
+    virtual int getThreadCount() const = 0;
+
+    // 等待执行的任务数
+    virtual size_t getQueueSize() = 0;
+
+    // 队列已满被拒绝的任务数
+    virtual uint64_t getRejected() const = 0;
+
+    virtual const char *getName() const = 0;
+
+    /**
+     * @brief 根据名称创建线程池
+     * queue(默认): WorkerPool
+     * work_stealing: WorkStealingPool
+     * @param queue_size: 等待执行的任务数上限, <= 0 不限制
+     * @note 未知的名称使用 queue
+     */
+    static Executor *Create(const std::string &type, int threads, int queue_size);
+};
+
+} // namespace rapidrpc
+
+#endif // RAPIDRPC_COMMON_EXECUTOR_H
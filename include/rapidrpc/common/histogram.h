@@ -0,0 +1,81 @@
+/**
+ * @file histogram.h
+ * 无锁直方图，用于 EventLoop 运行指标(等待时间、处理时间、就绪事件数、队列长度、定时器延迟)
+ * 1. 按 2 的幂分桶: 桶 0 记录 0，桶 i 记录 [2^(i-1), 2^i)，记录一次只需要几次原子读写
+ * 2. 只允许一个线程写(EventLoop 线程)，任意线程可以通过 snapshot() 读取，读取的快照不保证各个桶完全一致
+ */
+
+#ifndef RAPIDRPC_COMMON_HISTOGRAM_H
+#define RAPIDRPC_COMMON_HISTOGRAM_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace rapidrpc {
+
+/**
+ * @brief 直方图的快照，可以在任意线程读取和计算
+ */
+struct HistogramSnapshot {
+    static constexpr int BUCKETS = 64;
+
+    uint64_t m_buckets[BUCKETS] = {0};
+    uint64_t m_count{0}; // 记录次数
+    uint64_t m_sum{0};   // 记录值的和
+    uint64_t m_max{0};   // 记录的最大值
+
+    double mean() const;
+
+    /**
+     * @brief 估算百分位数
+     * @param p: 0 ~ 100
+     * @return 所在桶的上界(不超过最大值)
+     */
+    uint64_t percentile(double p) const;
+
+    // count, mean, p50, p99, max
+    std::string toString() const;
+};
+
+/**
+ * @brief 单写多读的无锁直方图
+ */
+class Histogram {
+public:
+    /**
+     * @brief 记录一个值，只能由一个线程调用
+     */
+    void record(uint64_t value) {
+        int index = BucketIndex(value);
+        m_buckets[index].store(m_buckets[index].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        m_sum.store(m_sum.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        if (value > m_max.load(std::memory_order_relaxed)) {
+            m_max.store(value, std::memory_order_relaxed);
+        }
+        m_count.store(m_count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 获取快照，可以在其他线程调用
+     */
+    HistogramSnapshot snapshot() const;
+
+    static int BucketIndex(uint64_t value) {
+        if (value == 0) {
+            return 0;
+        }
+        int index = 64 - __builtin_clzll(value);
+        return index < HistogramSnapshot::BUCKETS ? index : HistogramSnapshot::BUCKETS - 1;
+    }
+
+private:
+    std::atomic<uint64_t> m_buckets[HistogramSnapshot::BUCKETS] = {};
+    std::atomic<uint64_t> m_count{0};
+    std::atomic<uint64_t> m_sum{0};
+    std::atomic<uint64_t> m_max{0};
+};
+
+} // namespace rapidrpc
+
+#endif // RAPIDRPC_COMMON_HISTOGRAM_H
@@ -0,0 +1,175 @@
+/**
+ * @file inline_function.h
+ * 只能移动(move-only)的可调用对象包装，替代 EventLoop/FdEvent/TimerEvent 中的 std::function
+ * 1. 捕获对象不超过 InlineSize 字节时直接保存在对象内部(small buffer)，不分配堆内存
+ *    (std::function 超过两个指针大小就会分配，例如 RpcChannel 中捕获 req, channel 的 lambda)
+ * 2. 只能移动，不能拷贝，避免回调函数在传递过程中被拷贝
+ * 3. 超过 InlineSize 的对象退化为堆分配，并计数，可通过 HeapAllocations() 查看
+ */
+
+#ifndef RAPIDRPC_COMMON_INLINE_FUNCTION_H
+#define RAPIDRPC_COMMON_INLINE_FUNCTION_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace rapidrpc {
+
+namespace detail {
+// 所有 InlineFunction 实例化类型共享的堆分配计数
+inline std::atomic<uint64_t> g_inline_function_heap_allocs{0};
+
+template <typename F>
+bool isNullCallable(const F &) {
+    return false;
+}
+template <typename Sig>
+bool isNullCallable(const std::function<Sig> &f) {
+    return !f;
+}
+template <typename R, typename... Args>
+bool isNullCallable(R (*f)(Args...)) {
+    return f == nullptr;
+}
+} // namespace detail
+
+template <typename Signature, size_t InlineSize = 56>
+class InlineFunction;
+
+template <typename R, typename... Args, size_t InlineSize>
+class InlineFunction<R(Args...), InlineSize> {
+public:
+    InlineFunction() noexcept = default;
+    InlineFunction(std::nullptr_t) noexcept {}
+
+    template <typename F, typename = std::enable_if_t<!std::is_same<std::decay_t<F>, InlineFunction>::value
+                                                      && std::is_invocable_r<R, std::decay_t<F> &, Args...>::value>>
+    InlineFunction(F &&f) {
+        using Fn = std::decay_t<F>;
+        if (detail::isNullCallable(f)) {
+            return;
+        }
+        if constexpr (IsInline<Fn>()) {
+            ::new (static_cast<void *>(&m_storage)) Fn(std::forward<F>(f));
+            m_ops = &InlineOps<Fn>::s_ops;
+        }
+        else {
+            *reinterpret_cast<Fn **>(&m_storage) = new Fn(std::forward<F>(f));
+            m_ops = &HeapOps<Fn>::s_ops;
+            detail::g_inline_function_heap_allocs.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    InlineFunction(InlineFunction &&other) noexcept {
+        moveFrom(other);
+    }
+
+    InlineFunction &operator=(InlineFunction &&other) noexcept {
+        if (this != &other) {
+            reset();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    InlineFunction &operator=(std::nullptr_t) noexcept {
+        reset();
+        return *this;
+    }
+
+    InlineFunction(const InlineFunction &) = delete;
+    InlineFunction &operator=(const InlineFunction &) = delete;
+
+    ~InlineFunction() {
+        reset();
+    }
+
+    explicit operator bool() const noexcept {
+        return m_ops != nullptr;
+    }
+
+    R operator()(Args... args) const {
+        return m_ops->invoke(const_cast<void *>(static_cast<const void *>(&m_storage)), std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief 进程内所有 InlineFunction 因超过内联大小而分配堆内存的次数
+     */
+    static uint64_t HeapAllocations() {
+        return detail::g_inline_function_heap_allocs.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Ops {
+        R (*invoke)(void *storage, Args &&...args);
+        void (*move)(void *dst, void *src) noexcept; // 移动到 dst 并析构 src
+        void (*destroy)(void *storage) noexcept;
+    };
+
+    template <typename Fn>
+    static constexpr bool IsInline() {
+        return sizeof(Fn) <= InlineSize && alignof(Fn) <= alignof(std::max_align_t)
+               && std::is_nothrow_move_constructible<Fn>::value;
+    }
+
+    template <typename Fn>
+    struct InlineOps {
+        static R invoke(void *storage, Args &&...args) {
+            return (*static_cast<Fn *>(storage))(std::forward<Args>(args)...);
+        }
+        static void move(void *dst, void *src) noexcept {
+            ::new (dst) Fn(std::move(*static_cast<Fn *>(src)));
+            static_cast<Fn *>(src)->~Fn();
+        }
+        static void destroy(void *storage) noexcept {
+            static_cast<Fn *>(storage)->~Fn();
+        }
+        static constexpr Ops s_ops{&invoke, &move, &destroy};
+    };
+
+    template <typename Fn>
+    struct HeapOps {
+        static R invoke(void *storage, Args &&...args) {
+            return (**static_cast<Fn **>(storage))(std::forward<Args>(args)...);
+        }
+        static void move(void *dst, void *src) noexcept {
+            *static_cast<Fn **>(dst) = *static_cast<Fn **>(src);
+        }
+        static void destroy(void *storage) noexcept {
+            delete *static_cast<Fn **>(storage);
+        }
+        static constexpr Ops s_ops{&invoke, &move, &destroy};
+    };
+
+    void moveFrom(InlineFunction &other) noexcept {
+        if (other.m_ops) {
+            other.m_ops->move(&m_storage, &other.m_storage);
+            m_ops = other.m_ops;
+            other.m_ops = nullptr;
+        }
+    }
+
+    void reset() noexcept {
+        if (m_ops) {
+            const Ops *ops = m_ops;
+            m_ops = nullptr;
+            ops->destroy(&m_storage);
+        }
+    }
+
+private:
+    alignas(std::max_align_t) unsigned char m_storage[InlineSize];
+    const Ops *m_ops{nullptr};
+};
+
+// EventLoop 任务、FdEvent 回调、TimerEvent 任务统一使用的类型
+using Task = InlineFunction<void()>;
+
+} // namespace rapidrpc
+
+#endif // RAPIDRPC_COMMON_INLINE_FUNCTION_H
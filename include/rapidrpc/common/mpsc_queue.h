@@ -0,0 +1,56 @@
+/**
+ * @file mpsc_queue.h
+ * 无锁的多生产者单消费者(MPSC)侵入式队列, 基于 Dmitry Vyukov 的 intrusive MPSC node-based queue
+ * 生产者(任意线程) push 只需要一次原子交换，消费者(EventLoop 线程) pop 没有原子读改写操作
+ */
+
+#ifndef RAPIDRPC_COMMON_MPSC_QUEUE_H
+#define RAPIDRPC_COMMON_MPSC_QUEUE_H
+
+#include <atomic>
+
+namespace rapidrpc {
+
+class MpscQueue {
+public:
+    /**
+     * @brief 队列节点, 元素类型需要继承 Node，由使用者负责分配和释放
+     */
+    struct Node {
+        std::atomic<Node *> m_next{nullptr};
+    };
+
+public:
+    MpscQueue();
+    ~MpscQueue() = default;
+
+    MpscQueue(const MpscQueue &) = delete;
+    MpscQueue &operator=(const MpscQueue &) = delete;
+
+    /**
+     * @brief 添加节点到队尾, thread safe, wait-free
+     */
+    void push(Node *node);
+
+    /**
+     * @brief 取出队首节点，只能由唯一的消费者线程调用
+     * @return 队首节点; 队列为空，或者生产者正在 push 尚未完成时返回 nullptr
+     * @note 返回 nullptr 时如果有生产者未完成 push，该生产者完成后再唤醒消费者即可
+     */
+    Node *pop();
+
+    /**
+     * @brief 队列是否为空，只能由消费者线程调用
+     * @note 正在 push(已经交换 head) 的节点也算作非空
+     */
+    bool empty() const;
+
+private:
+    std::atomic<Node *> m_head; // 生产者添加的位置(最新的节点)
+    Node *m_tail;               // 消费者取出的位置(最早的节点)
+    Node m_stub;                // 哨兵节点
+};
+
+} // namespace rapidrpc
+
+#endif // !RAPIDRPC_COMMON_MPSC_QUEUE_H
@@ -4,6 +4,7 @@
 #include <sys/types.h>
 #include <unistd.h>
 #include <string>
+#include <vector>
 namespace rapidrpc {
 pid_t getPid();
 pid_t getThreadId();
@@ -11,8 +12,37 @@ pid_t getThreadId();
 ssize_t readn(int fd, void *buf, size_t count);
 ssize_t writen(int fd, const void *buf, size_t count);
 
+// 系统时间(gettimeofday), 单位 ms, 会随系统时间(NTP)调整跳变, 用于显示/日志
 int64_t getNowMs();
+// 单调时钟(CLOCK_MONOTONIC, vDSO 不陷入内核), 用于定时器/超时和计算时间间隔，单位 us
+int64_t getMonotonicUs();
+// 单调时钟, 单位 ns
+int64_t getMonotonicNs();
+
+// 线程局部的缓存时钟: EventLoop 每轮循环刷新一次(等待事件返回后、执行任务前)，
+// 同一轮中的定时器、日志、统计读取缓存的时间，而不是每个事件读取一次时钟;
+// 没有刷新过(非 EventLoop 线程/EventLoop 未运行)时读取实时时钟。需要精确时间时直接使用 getMonotonicUs()
+// 刷新缓存的单调时钟(us), 系统时间在读取时再计算
+void updateCachedClock(int64_t monotonic_us);
+// 清除缓存，之后读取实时时钟
+void clearCachedClock();
+// 缓存的单调时钟, 单位 us
+int64_t getCachedMonotonicUs();
+// 缓存的系统时间, 单位 us, 每轮循环最多读取一次 gettimeofday
+int64_t getCachedNowUs();
 std::string getFormatTime(int64_t ms);
 
+// 线程放置: 绑定 CPU、线程名称、NUMA 内存策略, 都作用于当前线程
+// 解析 CPU 列表, 例如 "0-3,8,10-11", 格式错误时返回空
+std::vector<int> parseCpuList(const std::string &cpus);
+// 绑定当前线程到 cpus 中的 CPU, 失败返回 false 并设置 errno
+bool setThreadAffinity(const std::vector<int> &cpus);
+// 设置当前线程的名称, 用于 top -H / perf 区分线程
+// 超过 15 个字符时截断, 保留最后一个 '-' 之后的序号, 例如 rapidrpc-worker-12 为 rapidrpc-wor-12
+void setThreadName(const std::string &name);
+// 当前线程之后分配的内存优先使用所在 CPU 的 NUMA 节点(MPOL_LOCAL, 首次访问时分配物理页)
+// 失败返回 false 并设置 errno(例如内核不支持 NUMA)
+bool setLocalMemoryPolicy();
+
 } // namespace rapidrpc
 #endif // !RAPIDRPC_COMMON_UTIL_H
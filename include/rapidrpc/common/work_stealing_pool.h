@@ -0,0 +1,97 @@
+/**
+ * @file work_stealing_pool.h
+ * 工作窃取的业务线程池: 每个业务线程一个 Chase-Lev 双端队列, 没有所有线程共享的队列和锁
+ * - IO 线程提交的任务放入固定的一个业务线程(第一次提交时轮询分配)的收件箱，同一 IO 线程解码的请求
+ *   优先由同一业务线程执行(局部性)
+ * - 业务线程中提交的任务(嵌套)放入自己的双端队列
+ * - 空闲的业务线程随机选择其他线程窃取，避免执行时间长的任务阻塞同一线程后面的任务
+ */
+
+#ifndef RAPIDRPC_COMMON_WORK_STEALING_POOL_H
+#define RAPIDRPC_COMMON_WORK_STEALING_POOL_H
+
+#include "rapidrpc/common/executor.h"
+#include "rapidrpc/common/chase_lev_deque.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace rapidrpc {
+
+class WorkStealingPool: public Executor {
+public:
+    /**
+     * @brief 创建并启动 threads 个业务线程(线程名称 rapidrpc-worker-<i>, 截断为 15 个字符)
+     * @param queue_size: 所有线程等待执行的任务数之和的上限, <= 0 不限制
+     */
+    WorkStealingPool(int threads, int queue_size);
+
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool &) = delete;
+    WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+    bool submit(Task task) override;
+
+    void stop() override;
+
+    int getThreadCount() const override {
+        return static_cast<int>(m_workers.size());
+    }
+
+    size_t getQueueSize() override {
+        int64_t pending = m_pending.load(std::memory_order_relaxed);
+        return pending > 0 ? static_cast<size_t>(pending) : 0;
+    }
+
+    uint64_t getRejected() const override {
+        return m_rejected.load(std::memory_order_relaxed);
+    }
+
+    const char *getName() const override {
+        return "work_stealing";
+    }
+
+    // 从其他线程窃取并执行的任务数
+    uint64_t getStolen() const;
+
+private:
+    struct Worker {
+        ChaseLevDeque<Task> m_deque; // 只有本线程 push/take
+        std::mutex m_inbox_mutex;    // 保护 m_inbox
+        std::deque<Task *> m_inbox;  // 其他线程(IO 线程)提交的任务
+        uint64_t m_random{0};        // 选择窃取对象的随机数状态
+        std::atomic<uint64_t> m_stolen{0};
+        std::thread m_thread;
+    };
+
+    void run(int index);
+
+    // 按顺序: 自己的队列 -> 自己的收件箱 -> 随机窃取其他线程的队列和收件箱
+    Task *findTask(int index);
+
+    Task *steal(int index);
+
+private:
+    const uint64_t m_id; // 进程内唯一, 外部线程按 id 记录固定放入的业务线程
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    size_t m_max_queue_size{0}; // 0 不限制
+
+    std::atomic<int64_t> m_pending{0};     // 已经提交但是还没有开始执行的任务数
+    std::atomic<uint32_t> m_next_home{0};  // 为提交任务的外部线程轮询分配业务线程
+    std::atomic<uint64_t> m_rejected{0};
+    std::atomic<bool> m_stop{false};
+
+    std::mutex m_sleep_mutex; // 空闲线程在 m_sleep_cond 上等待
+    std::condition_variable m_sleep_cond;
+    std::atomic<int> m_sleepers{0};
+};
+
+} // namespace rapidrpc
+
+#endif // RAPIDRPC_COMMON_WORK_STEALING_POOL_H
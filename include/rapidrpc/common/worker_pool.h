@@ -0,0 +1,72 @@
+/**
+ * @file worker_pool.h
+ * 业务线程池: 会阻塞的服务(例如访问数据库、sleep)在线程池中执行，不阻塞 IO 线程上的其他连接
+ * 有界队列, 队列已满时 submit 立即返回 false(由调用者返回错误)，不会阻塞 IO 线程
+ */
+
+#ifndef RAPIDRPC_COMMON_WORKER_POOL_H
+#define RAPIDRPC_COMMON_WORKER_POOL_H
+
+#include "rapidrpc/common/executor.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace rapidrpc {
+
+class WorkerPool: public Executor {
+public:
+    /**
+     * @brief 创建并启动 threads 个业务线程(线程名称 rapidrpc-worker-<i>, 截断为 15 个字符)
+     * @param queue_size: 等待执行的任务数上限, <= 0 不限制
+     */
+    WorkerPool(int threads, int queue_size);
+
+    /**
+     * @brief 执行完队列中剩余的任务后停止所有线程
+     */
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool &) = delete;
+    WorkerPool &operator=(const WorkerPool &) = delete;
+
+    bool submit(Task task) override;
+
+    void stop() override;
+
+    int getThreadCount() const override {
+        return static_cast<int>(m_threads.size());
+    }
+
+    size_t getQueueSize() override;
+
+    uint64_t getRejected() const override {
+        return m_rejected.load(std::memory_order_relaxed);
+    }
+
+    const char *getName() const override {
+        return "queue";
+    }
+
+private:
+    void run(int index);
+
+private:
+    std::vector<std::thread> m_threads;
+
+    std::mutex m_mutex; // 保护 m_tasks, m_stop
+    std::condition_variable m_cond;
+    std::deque<Task> m_tasks;
+    size_t m_max_queue_size{0}; // 0 不限制
+    bool m_stop{false};
+
+    std::atomic<uint64_t> m_rejected{0};
+};
+
+} // namespace rapidrpc
+
+#endif // RAPIDRPC_COMMON_WORKER_POOL_H
@@ -0,0 +1,49 @@
+/**
+ * @file epoll_poller.h
+ * 基于 epoll(LT 模式) 的 Poller 实现，默认使用
+ */
+
+#ifndef RAPIDRPC_NET_EPOLL_POLLER_H
+#define RAPIDRPC_NET_EPOLL_POLLER_H
+
+#include "rapidrpc/net/poller.h"
+
+#include <vector>
+#include <stdint.h>
+
+namespace rapidrpc {
+
+class EpollPoller: public Poller {
+public:
+    EpollPoller();
+    ~EpollPoller();
+
+    bool addEvent(FdEvent *event) override;
+
+    void deleteEvent(FdEvent *event) override;
+
+    int poll(epoll_event *events, int max_events, int timeout_ms) override;
+
+    const char *getName() const override {
+        return "epoll";
+    }
+
+    bool isEdgeTriggeredSupported() const override {
+        return true;
+    }
+
+private:
+    bool isListening(int fd) const {
+        return static_cast<size_t>(fd) < m_listen_fds.size() * 64 && (m_listen_fds[fd / 64] & (1ULL << (fd % 64)));
+    }
+    void setListening(int fd, bool value);
+
+private:
+    int m_epoll_fd{-1}; // epoll fd
+
+    std::vector<uint64_t> m_listen_fds; // 监听的fd集合, 以 fd 为下标的位图
+};
+
+} // namespace rapidrpc
+
+#endif // RAPIDRPC_NET_EPOLL_POLLER_H
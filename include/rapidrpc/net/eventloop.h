@@ -4,15 +4,43 @@
 #include "rapidrpc/net/fd_event.h"
 #include "rapidrpc/net/wakeup_fd_event.h"
 #include "rapidrpc/net/timer.h"
+#include "rapidrpc/net/poller.h"
+#include "rapidrpc/common/mpsc_queue.h"
+#include "rapidrpc/common/inline_function.h"
+#include "rapidrpc/common/histogram.h"
 
 #include <sys/types.h>
-#include <set>
-#include <functional>
-#include <queue>
-#include <mutex>
+#include <sys/epoll.h>
+#include <vector>
+#include <atomic>
 
 namespace rapidrpc {
 
+/**
+ * @brief EventLoop 运行统计的快照
+ */
+struct EventLoopStats {
+    uint64_t m_ctl_calls{0};           // 修改监听事件的次数(epoll_ctl 系统调用 / io_uring poll 请求)
+    uint64_t m_ctl_skipped{0};         // 监听事件没有变化而跳过的修改次数
+    uint64_t m_wakeup_writes{0};       // 写 wakeup fd 的次数(合并后, 每批跨线程任务最多一次)
+    uint64_t m_tasks_deferred{0};      // 超出每轮任务预算，剩余任务留到下一轮执行的次数
+    uint64_t m_stale_events{0};        // fd 关闭并被复用后丢弃的过期事件数(代数不一致)
+    uint64_t m_timer_settime{0};       // 定时器 timerfd_settime 的调用次数
+    uint64_t m_timer_settime_saved{0}; // 每轮合并/定时器 slack 节省的 timerfd_settime 调用次数
+
+    // 每轮循环的运行指标, 用于判断 IO 线程是否饱和(例如 m_poll_wait_us 很小而 m_handler_us 很大)
+    HistogramSnapshot m_poll_wait_us; // 等待事件的时间(us), 包括自旋
+    HistogramSnapshot m_handler_us;   // 执行任务和事件回调的时间(us)
+    HistogramSnapshot m_ready_events; // 就绪的事件数
+    HistogramSnapshot m_queue_depth;  // 待执行的任务数(包括上一轮剩余的任务)
+    HistogramSnapshot m_timer_lag_us; // 定时任务实际执行时间与到达时间的差(us)
+
+    // 负载, 用于选择新连接的 IO 线程(IOThreadPlacement)
+    int64_t m_connections{0};  // 当前的连接数
+    int64_t m_queued_bytes{0}; // 连接发送缓冲区中待发送的字节数
+    int m_busy_permille{0};    // 最近执行任务和事件回调的时间占比(千分比)
+};
+
 /**
  * @brief 事件循环类, 基于主从 Reactor 事件模型
  */
@@ -25,6 +53,7 @@ public:
 
     /**
      * @brief 唤醒 EventLoop
+     * @note 只有 EventLoop 阻塞在 epoll_wait 中，并且还没有被唤醒时才会写 wakeup fd
      */
     void wakeup();
 
@@ -63,17 +92,19 @@ public:
      * 线程。主要作用是，主线程添加任务并唤醒该Loop线程去执行任务队列中的任务，例如 迅速添加 fd 到 epoll 中，例如删除
      * fd等等。
      */
-    void addTask(std::function<void()> cb, bool is_wakeup = false);
+    void addTask(Task cb, bool is_wakeup = false);
 
     /**
      * @brief 添加定时任务
      * @param event: 定时任务
+     * @note 本线程中直接操作定时器(不加锁)，其他线程中添加到任务队列，由 EventLoop 线程执行
      */
     void addTimerEvent(TimerEvent::s_ptr event);
 
     /**
      * @brief 移除定时任务
      * @param event: 定时任务
+     * @note 同 addTimerEvent, 其他线程中调用时在 EventLoop 线程中异步删除
      */
     void deleteTimerEvent(TimerEvent::s_ptr event);
 
@@ -85,30 +116,177 @@ public:
 
     bool isLooping() const;
 
+    /**
+     * @brief 设置事件分发模式
+     * @param value: true(默认) 在 epoll_wait 返回后直接在本线程执行读写回调;
+     * false 将回调函数添加到任务队列，下一轮循环再执行
+     */
+    void setDirectDispatch(bool value);
+
+    /**
+     * @brief 设置自旋(busy poll)模式, 在 EventLoop 线程启动前或者本线程中调用
+     * @param max_spin_us: 阻塞等待前，以 0 超时轮询事件和任务队列的最大时间(us), 0 关闭
+     * @note 自适应: 自旋期间没有事件时自旋时间减半，直到直接阻塞；阻塞后很快有事件到达时恢复最大自旋时间
+     */
+    void setBusyPoll(int64_t max_spin_us);
+
+    /**
+     * @brief 当前自适应的自旋时间(us), 0 表示直接阻塞等待; 在本线程中调用
+     */
+    int64_t getBusyPollUs() const;
+
+    /**
+     * @brief 设置每轮循环执行任务的预算, 在 EventLoop 线程启动前或者本线程中调用
+     * @param max_tasks: 每轮最多执行的任务数, 0 不限制
+     * @param max_us: 每轮执行任务的最长时间(us), 0 不限制
+     * @note 超出预算的任务按顺序留到下一轮，先处理就绪的 IO 事件(不阻塞等待)，保证其他连接的延迟
+     */
+    void setTaskBudget(int max_tasks, int64_t max_us);
+
+    /**
+     * @brief 定时器使用分层时间轮(tick_ms > 0)或者 std::multimap(0), 默认使用配置 timer_wheel_tick_ms
+     * @note 已有的定时任务会被迁移; 其他线程中调用时在 EventLoop 线程中异步切换
+     */
+    void setTimingWheel(int64_t tick_ms);
+
+    /**
+     * @brief 定时器允许的延迟(us), 窗口内的到达时间共用一次 timerfd 唤醒, 默认使用配置 timer_slack_us
+     * @note 其他线程中调用时在 EventLoop 线程中异步设置
+     */
+    void setTimerSlack(int64_t slack_us);
+
+    /**
+     * @brief Poller 是否支持边缘触发(EPOLLET)
+     */
+    bool isEdgeTriggeredSupported() const;
+
+    /**
+     * @brief 获取运行统计, 可以在其他线程调用
+     */
+    EventLoopStats getStats() const;
+
+    /**
+     * @brief 负载计数, 由 TcpConnection 更新，IOThreadPlacement 读取，可以在任意线程调用
+     */
+    void addConnectionCount(int64_t delta) {
+        m_connections.fetch_add(delta, std::memory_order_relaxed);
+    }
+
+    void addQueuedBytes(int64_t delta) {
+        m_queued_bytes.fetch_add(delta, std::memory_order_relaxed);
+    }
+
+    int64_t getConnectionCount() const {
+        return m_connections.load(std::memory_order_relaxed);
+    }
+
+    int64_t getQueuedBytes() const {
+        return m_queued_bytes.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 已经交给业务线程池、响应还没有回到本线程的请求数; IOThreadGroup 排空线程时等待其为 0 才释放 EventLoop
+     */
+    void addPendingReplies(int64_t delta) {
+        m_pending_replies.fetch_add(delta, std::memory_order_relaxed);
+    }
+
+    int64_t getPendingReplies() const {
+        return m_pending_replies.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 最近约 100ms 内执行任务和事件回调的时间占比(千分比), 每轮循环按本轮时间加权更新
+     */
+    int getBusyPermille() const {
+        return m_busy_permille.load(std::memory_order_relaxed);
+    }
+
 private:
     void handleWakeUp();
 
+    /**
+     * @brief 批量取出并执行任务队列中当前已有的任务
+     * @note 执行期间新添加的任务留到下一轮循环执行; 超出预算的任务也留到下一轮
+     */
+    void runPendingTasks();
+
+    /**
+     * @brief 是否还有待执行的任务(任务队列或者上一轮超出预算剩余的任务)
+     */
+    bool hasPendingTasks() const;
+
+    /**
+     * @brief 分发一个就绪的事件: 直接执行回调，或者添加到任务队列
+     */
+    void dispatchEvent(FdEvent *fd_event, TriggerEvent event_type);
+
+    /**
+     * @brief 自旋轮询事件
+     * @return 就绪的事件数量，0 表示自旋结束没有事件(或者任务队列不为空)
+     */
+    int busyPoll();
+
+    /**
+     * @brief 更新繁忙比例, busy_us: 本轮执行任务和回调的时间, total_us: 本轮的总时间
+     */
+    void updateBusyRatio(int64_t busy_us, int64_t total_us);
+
+    // 在 EventLoop 线程中添加/修改/删除监听事件，跳过没有变化的修改
+    void updateEpollEvent(FdEvent *event);
+    void removeEpollEvent(FdEvent *event);
+
     void initWakeupFdEvent(); // add wakeup fd to epoll
     void initTimer();         // add timer fd to epoll
 
 private:
     pid_t m_tid{0}; // 线程id
 
-    int m_epoll_fd{0}; // epoll fd
+    Poller *m_poller{nullptr}; // IO 多路复用, epoll 或者 io_uring
 
     // int m_wakeup_fd{0}; // 用于唤醒的 fd
     WakeupFdEvent *m_wakeup_event{nullptr}; // 用于唤醒的 FdEvent，封装 m_wakeup_fd
 
-    bool m_stop_flag{false}; // 是否停止 EventLoop
+    std::atomic<bool> m_stop_flag{false}; // 是否停止 EventLoop
+
+    // 唤醒合并: 只有 loop 即将/正在阻塞在 epoll_wait，且没有未读取的唤醒时才写 wakeup fd
+    std::atomic<bool> m_sleeping{false};       // 是否阻塞在 epoll_wait 中
+    std::atomic<bool> m_wakeup_pending{false}; // 是否已经写入 wakeup fd 且尚未读取
+    std::atomic<uint64_t> m_wakeup_writes{0};  // 写 wakeup fd 的次数, 任意线程更新
 
-    std::set<int> m_listen_fds; // 监听的fd集合
+    // 待处理的任务(当前Loop循环结束后处理), 无锁 MPSC 队列，任意线程添加，只由本线程取出
+    MpscQueue m_pending_tasks;
+    std::vector<MpscQueue::Node *> m_task_batch; // 每轮循环取出的一批任务，复用内存
+    size_t m_task_batch_index{0};                // m_task_batch 中下一个要执行的任务
 
-    std::mutex m_mutex;
-    std::queue<std::function<void()>> m_pending_tasks; // 待处理的任务(当前Loop循环结束后处理)
+    int m_task_budget_max{0};        // 每轮最多执行的任务数, 0 不限制
+    int64_t m_task_budget_max_us{0}; // 每轮执行任务的最长时间(us), 0 不限制
 
     Timer *m_timer{nullptr}; // 定时器, 管理定时任务
 
     bool m_is_looping{false}; // 是否正在循环
+
+    bool m_direct_dispatch{true}; // 是否直接分发就绪事件
+
+    int64_t m_busy_poll_max_us{0}; // 最大自旋时间(us), 0 关闭
+    int64_t m_busy_poll_us{0};     // 当前自适应的自旋时间(us)
+
+    // 统计, 只由本线程更新，其他线程读取
+    std::atomic<uint64_t> m_ctl_calls{0};
+    std::atomic<uint64_t> m_ctl_skipped{0};
+    std::atomic<uint64_t> m_tasks_deferred{0};
+    std::atomic<uint64_t> m_stale_events{0};
+    std::atomic<int64_t> m_connections{0};
+    std::atomic<int64_t> m_queued_bytes{0};
+    std::atomic<int64_t> m_pending_replies{0};
+    std::atomic<int> m_busy_permille{0};
+    double m_busy_ratio{0}; // m_busy_permille 的加权平均值，只由本线程使用
+    Histogram m_poll_wait_hist;
+    Histogram m_handler_hist;
+    Histogram m_ready_events_hist;
+    Histogram m_queue_depth_hist;
+
+    std::vector<epoll_event> m_result_events; // epoll_wait 返回的事件, 大小自适应
 };
 } // namespace rapidrpc
 
@@ -1,14 +1,18 @@
 #ifndef RAPIDRPC_NET_FD_EVENT_H
 #define RAPIDRPC_NET_FD_EVENT_H
 
-#include <functional>
+#include "rapidrpc/common/inline_function.h"
+
 #include <sys/epoll.h>
+#include <stdint.h>
+#include <atomic>
 
 namespace rapidrpc {
 
 enum class TriggerEvent {
-    IN_EVENT = EPOLLIN,   // 读事件
-    OUT_EVENT = EPOLLOUT, // 写事件
+    IN_EVENT = EPOLLIN,     // 读事件
+    OUT_EVENT = EPOLLOUT,   // 写事件
+    ERROR_EVENT = EPOLLERR, // 错误/挂断事件(EPOLLERR, EPOLLHUP), 用于关闭连接
 };
 
 /**
@@ -31,43 +35,132 @@ protected:
 
 public:
     /**
-     * @brief return callback function
+     * @brief 在当前线程直接执行事件的回调函数, 用于 EventLoop 直接分发
+     * @note 回调函数执行期间可能会重新 listen/clearEvent/close，因此执行前先移出回调函数，
+     * 执行后如果没有被重新设置并且仍在监听该事件，再恢复，避免回调函数执行时析构自身
      */
-    std::function<void()> getHandler(TriggerEvent even_type);
+    void handleEvent(TriggerEvent event_type);
+
+    /**
+     * @brief 是否正在监听 TriggerEvent 事件
+     */
+    bool isListening(TriggerEvent event_type) const {
+        return m_listen_events.events & static_cast<uint32_t>(event_type);
+    }
 
     /**
      * @brief 设置监听事件和回调函数
      * @param event: 监听事件，这里是原基础上添加的事件
      * @param callback: 该事件的回调函数
      */
-    void listen(TriggerEvent event_type, std::function<void()> callback);
+    void listen(TriggerEvent event_type, Task callback);
 
     int getFd() const {
         return m_fd;
     }
 
+    /**
+     * @brief 监听事件, data 为 EncodeEpollData(this, 当前代数)
+     */
     epoll_event getEpollEvent() {
-        return m_listen_events;
+        epoll_event event = m_listen_events;
+        event.data.u64 = EncodeEpollData(this, getGeneration());
+        return event;
+    }
+
+    /**
+     * @brief fd 的代数, 每次 close 加一
+     * FdEventGroup 中同一个 fd 复用同一个 FdEvent，代数用来区分关闭前后的连接：
+     * 注册时的代数写入 epoll data, 跨线程的添加/删除任务也记录提交时的代数，不一致时说明已经过期
+     */
+    uint32_t getGeneration() const {
+        return m_generation.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief 注册时的代数 generation 是否已经过期(只比较 epoll data 中保存的低 GENERATION_BITS 位)
+     */
+    bool isStale(uint32_t generation) const {
+        return ((generation ^ getGeneration()) & GENERATION_MASK) != 0;
+    }
+
+    /**
+     * @brief epoll data(64 位) 中同时保存 FdEvent 指针和代数: 低 48 位为指针(x86-64/aarch64 用户空间地址),
+     * 高 16 位为代数的低 16 位, 不需要额外的查表就能丢弃过期的事件
+     */
+    static uint64_t EncodeEpollData(FdEvent *event, uint32_t generation) {
+        return reinterpret_cast<uintptr_t>(event) |
+               (static_cast<uint64_t>(generation & GENERATION_MASK) << POINTER_BITS);
+    }
+
+    static FdEvent *DecodeEpollData(uint64_t data, uint32_t *generation) {
+        *generation = static_cast<uint32_t>(data >> POINTER_BITS);
+        return reinterpret_cast<FdEvent *>(static_cast<uintptr_t>(data & ((1ULL << POINTER_BITS) - 1)));
+    }
+
+    /**
+     * @brief 设置边缘触发(EPOLLET)，需要在添加到 EventLoop 之前设置
+     * @note 边缘触发时回调函数需要读/写直到 EAGAIN
+     */
+    void setEdgeTriggered(bool value) {
+        if (value) {
+            m_listen_events.events |= EPOLLET;
+        }
+        else {
+            m_listen_events.events &= ~EPOLLET;
+        }
+    }
+
+    bool isEdgeTriggered() const {
+        return m_listen_events.events & EPOLLET;
     }
 
     /**
      * @brief 关闭fd
+     * @note 关闭后内核自动从 epoll 中删除，同时清除注册状态，代数加一
      */
     void close();
 
+    /**
+     * @brief 是否已经注册到 EventLoop 的 Poller(内核) 中，以及注册的监听事件
+     * 由 EventLoop 更新，用于跳过监听事件没有变化的修改
+     */
+    bool isRegistered() const {
+        return m_registered;
+    }
+
+    uint32_t getRegisteredEvents() const {
+        return m_registered_events;
+    }
+
+    void setRegistered(bool registered, uint32_t events = 0) {
+        m_registered = registered;
+        m_registered_events = registered ? events : 0;
+    }
+
     /**
      * @brief 取消监听 TriggerEvent 事件和清空回调函数
      */
     void clearEvent(TriggerEvent event_type);
 
+public:
+    static constexpr int POINTER_BITS = 48;
+    static constexpr uint32_t GENERATION_MASK = 0xffff;
+
 protected:
     // fd
     int m_fd{-1};
     // listen event
     epoll_event m_listen_events;
 
-    std::function<void()> m_read_callback;
-    std::function<void()> m_write_callback;
+    bool m_registered{false};       // 是否已经注册到 Poller 中
+    uint32_t m_registered_events{0}; // 注册到 Poller 中的监听事件
+
+    std::atomic<uint32_t> m_generation{0}; // fd 的代数, close 时加一(其他线程可能读取)
+
+    Task m_read_callback;
+    Task m_write_callback;
+    Task m_error_callback;
 };
 } // namespace rapidrpc
 
@@ -1,7 +1,10 @@
 /**
  * @file fd_event_group.h
- * 使用全局对象，管理所有的fd_event，fd 一般是顺序分配的，所以可以使用vector来管理
+ * 使用全局对象，管理所有的fd_event，fd 一般是顺序分配的，所以使用按 fd 下标的两级分段表来管理
  * 避免fd_event对象的频繁创建，管理生命周期
+ *
+ * 第一级是固定大小的段指针数组，第二级是每段 SEGMENT_SIZE 个 FdEvent 指针；段和 FdEvent 在第一次访问时
+ * 分配并通过 CAS 发布，之后不会移动或释放，所以查找不加锁(两次 acquire 读)，也不需要 resize
  */
 
 #ifndef RAPIDRPC_NET_FD_EVENT_GROUP_H
@@ -9,15 +12,20 @@
 
 #include "rapidrpc/net/fd_event.h"
 
-#include <vector>
-#include <mutex>
+#include <atomic>
 
 namespace rapidrpc {
 
 class FdEventGroup {
 
 public:
-    FdEventGroup(int size);
+    static constexpr int SEGMENT_BITS = 10;
+    static constexpr int SEGMENT_SIZE = 1 << SEGMENT_BITS; // 每段 1024 个 fd
+    static constexpr int MAX_SEGMENTS = 1 << 14;           // 最多 16M 个 fd
+    static constexpr int MAX_FD = SEGMENT_SIZE * MAX_SEGMENTS;
+
+public:
+    FdEventGroup();
     ~FdEventGroup();
 
     /**
@@ -26,15 +34,26 @@ public:
     static FdEventGroup *GetGlobalFdEventGroup();
 
     /**
-     * @brief 获取 fd 对应的 FdEvent
-     * 如果 fd 不存在，增加 vector 的大小并添加新的 FdEvent
+     * @brief 获取 fd 对应的 FdEvent, thread safe, 不加锁
+     * 已经分配时是 wait-free 的；第一次访问时分配段/FdEvent 并 CAS 发布，竞争失败的一方释放自己分配的对象
+     * FdEvent 不会释放，fd 关闭(FdEvent.close)后内核复用相同的 fd 时复用同一个 FdEvent
+     * @return fd 无效(< 0 或 >= MAX_FD)时返回 nullptr
      */
     FdEvent *getFdEvent(int fd);
 
+    /**
+     * @brief 已经分配的 FdEvent 数量(用于测试和统计)
+     */
+    int getAllocatedCount() const { return m_allocated.load(std::memory_order_relaxed); }
+
 private:
-    std::vector<FdEvent *> m_fd_event_group;
-    std::mutex m_mutex; // 保护 m_fd_event_group
+    struct Segment {
+        std::atomic<FdEvent *> m_events[SEGMENT_SIZE]{};
+    };
+
+    std::atomic<Segment *> m_segments[MAX_SEGMENTS]{};
+    std::atomic<int> m_allocated{0}; // 已经分配的 FdEvent 数量
 };
 } // namespace rapidrpc
 
-#endif
\ No newline at end of file
+#endif
@@ -4,15 +4,26 @@
 #include "rapidrpc/net/eventloop.h"
 
 #include <thread>
+#include <string>
+#include <vector>
 #include <semaphore.h>
 
 namespace rapidrpc {
 
 class IOThread {
 public:
-    IOThread();
+    /**
+     * @param index: 在 IOThreadGroup 中的序号, 用于线程名称(rapidrpc-io-<index>)和选择绑定的 CPU(配置 io_thread_cpus)
+     */
+    explicit IOThread(int index = 0);
     ~IOThread();
 
+    /**
+     * @brief 绑定当前线程到 cpus(不为空时)并且之后的内存优先分配在本地 NUMA 节点, name 只用于日志
+     * @note 在创建 EventLoop 和分配其他内存之前调用, 首次访问的内存才会分配在本地节点; 不修改线程名称
+     */
+    static void BindCurrentThread(const std::string &name, const std::vector<int> &cpus);
+
     /**
      * @brief 获取线程的 EventLoop 对象
      * @note 用于获取该线程的 EventLoop 对象，用于添加事件，例如常规套接字事件，定时任务，停止线程loop等
@@ -35,6 +46,7 @@ private:
     static void *Main(void *arg);
 
 private:
+    int m_index{0};         // 在 IOThreadGroup 中的序号
     pid_t m_tid{-1};        // 线程ID
     std::thread m_thread{}; // 线程对象
 
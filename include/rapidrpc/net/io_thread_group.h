@@ -7,14 +7,28 @@
 #define RAPIDRPC_NET_IO_THREAD_GROUP_H
 
 #include "rapidrpc/net/io_thread.h"
+#include "rapidrpc/net/io_thread_placement.h"
 
+#include <mutex>
+#include <stdint.h>
 #include <vector>
 
 namespace rapidrpc {
 
+/**
+ * @brief IO 线程数的自动调整策略, 见 IOThreadGroup::autoscale
+ */
+struct IOThreadAutoscale {
+    int m_min_threads{1};
+    int m_max_threads{1};
+    int m_high_permille{800}; // 工作中线程的平均繁忙比例高于该值时增加一个线程
+    int m_low_permille{200};  // 低于该值并且排空一个线程后平均值仍低于 m_high_permille 时排空一个线程
+};
+
 /**
  * @brief IOThreadGroup 类，用于管理多个 IOThread 对象( SubReactor 线程)
- * @note 只在主线程中使用，用于管理多个 IOThread 对象/SubReactor 线程
+ * @note 线程数可以在运行时调整: addIOThread 增加的线程接收新连接; drainIOThread 排空的线程不再接收新连接，
+ * 已有的连接关闭后由 reapDrained 停止并释放。所有方法可以在任意线程调用
  */
 class IOThreadGroup {
 public:
@@ -24,14 +38,87 @@ public:
     void start();
     void join();
 
+    /**
+     * @brief 选择一个工作中的 IOThread, 用于分配新连接, 由放置策略决定(默认使用配置 io_thread_placement)
+     */
     IOThread *getIOThread();
 
+    /**
+     * @brief 增加一个 IOThread, 之后的新连接可以分配到该线程; 线程组已经 start 时立即启动
+     * @note 有正在排空的线程时优先恢复该线程(保留其连接)，不创建新线程
+     */
+    IOThread *addIOThread();
+
+    /**
+     * @brief 排空一个 IOThread: 不再分配新连接, 已有的连接继续处理直到关闭
+     * @param thread: 要排空的线程, nullptr 时选择连接数最少的线程
+     * @return 被排空的线程; 只剩一个工作中的线程或者 thread 不在工作中时返回 nullptr
+     */
+    IOThread *drainIOThread(IOThread *thread = nullptr);
+
+    /**
+     * @brief 停止并释放已经没有连接、也没有等待业务线程池响应的排空线程，由 TcpServer 定时调用
+     * @return 释放的线程数
+     */
+    int reapDrained();
+
+    /**
+     * @brief 获取排空时间超过 timeout_ms 的线程(每个线程只返回一次), 用于关闭其剩余的连接
+     */
+    std::vector<IOThread *> getDrainExpired(int64_t timeout_ms);
+
+    /**
+     * @brief 根据工作中线程的平均繁忙比例(EventLoop::getBusyPermille)增加或者排空一个线程
+     * 已经有线程在排空时不再排空; 每次调用唤醒工作中的线程一次, 空闲阻塞的线程也会刷新繁忙比例
+     * @return 1: 增加了一个线程; -1: 排空了一个线程; 0: 不变
+     */
+    int autoscale(const IOThreadAutoscale &policy);
+
+    /**
+     * @brief 设置放置策略, 取得 placement 的所有权; 在调用 getIOThread 的线程中设置
+     */
+    void setPlacement(IOThreadPlacement *placement);
+
+    IOThreadPlacement *getPlacement() const {
+        return m_placement;
+    }
+
+    /**
+     * @brief 获取第 index 个工作中的 IOThread(与线程创建顺序一致)
+     */
+    IOThread *getIOThread(int index) const;
+
+    // 工作中(接收新连接)的线程数
+    int getSize() const;
+
+    // 正在排空的线程数
+    int getDrainingCount() const;
+
+    /**
+     * @brief 获取每个工作中的 IOThread 的 EventLoop 运行统计(顺序与线程创建顺序一致), 可以在任意线程调用
+     * @note 用于判断 IO 线程是否饱和，调整 io_threads 配置
+     */
+    std::vector<EventLoopStats> getStats() const;
+
 private:
-    int m_size{0};                             // 线程数量
-    std::vector<IOThread *> m_io_thread_group; // 线程对象数组
+    struct DrainingThread {
+        IOThread *m_thread{nullptr};
+        int64_t m_start_ms{0};  // 开始排空的时间
+        bool m_expired{false}; // 已经由 getDrainExpired 返回
+    };
+
+    IOThread *drainIOThreadLocked(IOThread *thread);
+
+private:
+    mutable std::mutex m_mutex; // 保护下面的所有成员
+
+    int m_size{0};                             // 工作中的线程数量
+    std::vector<IOThread *> m_io_thread_group; // 工作中的线程对象数组
+    std::vector<DrainingThread> m_draining;    // 正在排空的线程
+    int m_next_index{0};                       // 下一个新线程的序号(线程名称)
+    bool m_started{false};
 
-    // 用于轮询选择线程
-    int m_index{0}; // 当前 getIOThread() 返回的线程索引
+    IOThreadPlacement *m_placement{nullptr}; // 新连接的放置策略
 };
 } // namespace rapidrpc
 
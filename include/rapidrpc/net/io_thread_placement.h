@@ -0,0 +1,44 @@
+/**
+ * @file io_thread_placement.h
+ * 新连接分配到哪个 IOThread 的策略, 由 IOThreadGroup::getIOThread 使用，通过 rapidrpc.xml 的 <io_thread_placement> 选择
+ * 负载来自每个 IO 线程 EventLoop 的计数: 连接数、待发送字节数、繁忙比例(见 EventLoop::getBusyPermille)
+ */
+
+#ifndef RAPIDRPC_NET_IO_THREAD_PLACEMENT_H
+#define RAPIDRPC_NET_IO_THREAD_PLACEMENT_H
+
+#include "rapidrpc/net/io_thread.h"
+
+#include <vector>
+#include <string>
+
+namespace rapidrpc {
+
+class IOThreadPlacement {
+public:
+    virtual ~IOThreadPlacement() {}
+
+    /**
+     * @brief 选择一个 IO 线程
+     * @param threads: 候选的 IO 线程, 不为空
+     * @return 选择的线程在 threads 中的下标
+     * @note 可能在多个线程中同时调用
+     */
+    virtual size_t select(const std::vector<IOThread *> &threads) = 0;
+
+    virtual const char *getName() const = 0;
+
+    /**
+     * @brief 根据名称创建策略
+     * round_robin(默认): 轮询
+     * least_connections: 连接数最少的线程
+     * least_queued_bytes: 待发送字节数最少的线程, 相同时连接数最少
+     * p2c_busy: 随机选择两个线程(power of two choices), 取繁忙比例较低的一个
+     * @note 未知的名称使用 round_robin
+     */
+    static IOThreadPlacement *Create(const std::string &type);
+};
+
+} // namespace rapidrpc
+
+#endif // RAPIDRPC_NET_IO_THREAD_PLACEMENT_H
@@ -0,0 +1,92 @@
+/**
+ * @file io_uring_poller.h
+ * 基于 io_uring(IORING_OP_POLL_ADD) 的 Poller 实现，直接使用系统调用，不依赖 liburing
+ * 1. 添加/修改/删除监听事件只写入提交队列(SQ)，和等待事件在同一次 io_uring_enter 中提交，
+ *    不再像 epoll 那样每次修改监听事件都需要一次 epoll_ctl 系统调用
+ * 2. 使用单次 poll，事件完成后在下一次 poll() 时重新提交，语义与 epoll LT 模式一致
+ *    (multishot poll 会合并同一 fd 的多次唤醒，语义接近 ET; TcpConnection 的 LT 读路径没有读到 EAGAIN 就返回,
+ *    依赖还有数据时再次通知)
+ * 3. 不支持边缘触发(EPOLLET)，重新提交的单次 poll 会立即返回可写事件
+ * 需要内核 5.11+(IORING_FEAT_EXT_ARG)，不支持时 Poller::Create 回退到 epoll
+ */
+
+#ifndef RAPIDRPC_NET_IO_URING_POLLER_H
+#define RAPIDRPC_NET_IO_URING_POLLER_H
+
+#include "rapidrpc/net/poller.h"
+
+#include <linux/io_uring.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+namespace rapidrpc {
+
+class IoUringPoller: public Poller {
+public:
+    IoUringPoller();
+    ~IoUringPoller();
+
+    /**
+     * @brief 创建 io_uring 并映射 SQ/CQ
+     * @param entries: 提交队列大小
+     * @return false: io_uring 不可用
+     */
+    bool init(unsigned entries = 256);
+
+    bool addEvent(FdEvent *event) override;
+
+    void deleteEvent(FdEvent *event) override;
+
+    int poll(epoll_event *events, int max_events, int timeout_ms) override;
+
+    const char *getName() const override {
+        return "io_uring";
+    }
+
+private:
+    // fd 注册信息, 以 fd 为下标
+    struct Registration {
+        FdEvent *m_event{nullptr}; // nullptr 表示未注册
+        uint64_t m_data{0};        // 注册时的 epoll data(FdEvent 指针和代数)
+        uint32_t m_events{0};      // 监听的事件
+        uint32_t m_gen{0};         // 每次提交 poll 加一，用于过滤已经取消/过期的完成事件
+        bool m_armed{false};       // 是否有正在等待的 poll 请求
+    };
+
+    io_uring_sqe *getSqe();
+
+    // 提交 SQ 中的请求，min_complete > 0 时等待完成事件
+    int submit(unsigned min_complete, int timeout_ms);
+
+    void armPoll(int fd, Registration &reg);
+    void cancelPoll(int fd, Registration &reg);
+
+private:
+    int m_ring_fd{-1};
+
+    void *m_ring_ptr{nullptr}; // SQ/CQ ring (IORING_FEAT_SINGLE_MMAP)
+    size_t m_ring_size{0};
+    io_uring_sqe *m_sqes{nullptr};
+    size_t m_sqes_size{0};
+
+    unsigned *m_sq_head{nullptr};
+    unsigned *m_sq_tail{nullptr};
+    unsigned *m_sq_array{nullptr};
+    unsigned m_sq_mask{0};
+    unsigned m_sq_entries{0};
+    unsigned m_sq_local_tail{0}; // 本地已填充的 SQE 位置
+    unsigned m_sq_submitted{0};  // 已提交给内核的 SQE 位置
+
+    unsigned *m_cq_head{nullptr};
+    unsigned *m_cq_tail{nullptr};
+    unsigned m_cq_mask{0};
+    io_uring_cqe *m_cqes{nullptr};
+
+    std::vector<Registration> m_registrations;
+    std::vector<int> m_rearm_fds; // 上一轮完成的 poll，需要重新提交
+};
+
+} // namespace rapidrpc
+
+#endif // RAPIDRPC_NET_IO_URING_POLLER_H
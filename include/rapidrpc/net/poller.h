@@ -0,0 +1,61 @@
+/**
+ * @file poller.h
+ * IO 多路复用的抽象接口，EventLoop 通过 Poller 监听 fd 事件，不直接依赖 epoll
+ * 目前支持 epoll(默认) 和 io_uring 两种实现，通过 rapidrpc.xml 的 <poller> 选择
+ */
+
+#ifndef RAPIDRPC_NET_POLLER_H
+#define RAPIDRPC_NET_POLLER_H
+
+#include "rapidrpc/net/fd_event.h"
+
+#include <sys/epoll.h>
+#include <string>
+
+namespace rapidrpc {
+
+class Poller {
+public:
+    virtual ~Poller() {}
+
+    /**
+     * @brief 添加 fd 的监听事件，fd 已经存在时更新其监听事件
+     * @param event: 监听的 FdEvent，监听的事件由 event->getEpollEvent() 给出
+     * @return false: 添加失败
+     */
+    virtual bool addEvent(FdEvent *event) = 0;
+
+    /**
+     * @brief 删除 fd 的监听事件
+     */
+    virtual void deleteEvent(FdEvent *event) = 0;
+
+    /**
+     * @brief 等待事件就绪
+     * @param events: 返回的就绪事件，events[i].events 为就绪的事件(EPOLLIN...),
+     * events[i].data 为注册时的 getEpollEvent().data(FdEvent* 和代数, 见 FdEvent::DecodeEpollData)
+     * @param max_events: events 数组大小
+     * @param timeout_ms: 超时时间(ms), -1 一直等待
+     * @return 就绪事件的数量，超时返回 0，出错返回 -1 并设置 errno
+     */
+    virtual int poll(epoll_event *events, int max_events, int timeout_ms) = 0;
+
+    virtual const char *getName() const = 0;
+
+    /**
+     * @brief 是否支持边缘触发(EPOLLET)
+     */
+    virtual bool isEdgeTriggeredSupported() const {
+        return false;
+    }
+
+    /**
+     * @brief 根据名称创建 Poller, "epoll" 或者 "io_uring"
+     * @note io_uring 不可用(内核版本过低/被禁止)时回退到 epoll
+     */
+    static Poller *Create(const std::string &type);
+};
+
+} // namespace rapidrpc
+
+#endif // RAPIDRPC_NET_POLLER_H
@@ -2,10 +2,13 @@
 #define RAPIDRPC_NET_RPC_DISPATCHER
 
 #include "rapidrpc/net/coder/abstract_protocol.h"
+#include "rapidrpc/common/executor.h"
+#include "rapidrpc/common/error_code.h"
 
 #include <memory>
 #include <string>
 #include <map>
+#include <set>
 #include <google/protobuf/service.h>
 
 namespace rapidrpc {
@@ -22,12 +25,46 @@ public:
 
     void dispatch(AbstractProtocol::s_ptr request, AbstractProtocol::s_ptr response);
 
+    /**
+     * @brief 创建业务线程池(服务端启动时按配置 worker_threads/worker_queue_size/worker_scheduler 创建),
+     * threads <= 0 不创建
+     * @param scheduler: 线程池类型, 见 Executor::Create
+     * @note 已经创建时不再重复创建
+     */
+    void initWorkerPool(int threads, int queue_size, const std::string &scheduler = "queue");
+
+    Executor *getWorkerPool() const {
+        return m_worker_pool.get();
+    }
+
+    /**
+     * @brief 设置服务的执行方式(配置 pooled_services), 在服务端启动前调用
+     * @param service_name: 服务名(proto 中的 service 名称), "*" 表示所有服务
+     * @param pooled: true 在业务线程池中执行; false(默认) 在 IO 线程中直接执行
+     */
+    void setServicePooled(const std::string &service_name, bool pooled);
+
+    /**
+     * @brief 请求是否在业务线程池中执行: 已经创建线程池，并且请求的服务设置为 pooled
+     */
+    bool isPooled(AbstractProtocol::s_ptr request);
+
+    /**
+     * @brief 不执行请求，直接设置错误响应(例如业务线程池队列已满)
+     */
+    void reject(AbstractProtocol::s_ptr request, AbstractProtocol::s_ptr response, Error err,
+                const std::string &err_info);
+
 private:
     // parse service name and method name from request
     bool parseServiceAndMethod(const std::string &full_name, std::string &service_name, std::string &method_name);
 
 private:
     std::map<std::string, service_s_ptr> m_services;
+
+    std::unique_ptr<Executor> m_worker_pool;   // 业务线程池, 没有配置时为空
+    std::set<std::string> m_pooled_services;   // 在业务线程池中执行的服务
+    bool m_pool_all_services{false};           // 所有服务都在业务线程池中执行
 };
 } // namespace rapidrpc
 
@@ -19,7 +19,8 @@
 /**
  * @brief create new Rpc controller
  * @param controllerName shared_ptr variable name
- * @note can set timeout(ms) by controllerName->SetTimeout(timeout) or get status by controllerName->Failed()
+ * @note can set timeout(ms) by controllerName->SetTimeout(timeout), timeout(us) by
+ * controllerName->SetTimeout(std::chrono::microseconds(timeout)), or get status by controllerName->Failed()
  */
 #define NEW_RPC_CONTROLLER(controllerName)                                                                             \
     std::shared_ptr<rapidrpc::RpcController> controllerName = std::make_shared<rapidrpc::RpcController>();
@@ -6,6 +6,7 @@
 
 #include <google/protobuf/service.h>
 #include <string>
+#include <chrono>
 
 namespace rapidrpc {
 
@@ -49,7 +50,12 @@ public:
 
     // 设置超时时间, 单位 ms; 默认 1000ms
     void SetTimeout(int timeout);
+    // 设置超时时间, 精确到 us, 如 SetTimeout(std::chrono::microseconds(300))
+    void SetTimeout(std::chrono::microseconds timeout);
+    // 超时时间, 单位 ms(向下取整)
     int GetTimeout() const;
+    // 超时时间, 单位 us
+    int64_t GetTimeoutUs() const;
 
 private:
     int m_error_code{0};
@@ -62,7 +68,7 @@ private:
     NetAddr::s_ptr m_local_addr;
     NetAddr::s_ptr m_peer_addr;
 
-    int m_timeout{1000}; // ms
+    int64_t m_timeout_us{1000000}; // us
 };
 
 } // namespace rapidrpc
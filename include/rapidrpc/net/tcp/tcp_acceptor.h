@@ -3,6 +3,7 @@
 
 #include "rapidrpc/net/tcp/net_addr.h"
 #include <memory>
+#include <sys/socket.h>
 
 namespace rapidrpc {
 
@@ -14,19 +15,33 @@ public:
      * Constructor
      * @param paddr Address to bind to
      * @param backlog Maximum number of pending connections
+     * @param reuse_port Set SO_REUSEPORT, multiple acceptors(one per IO thread) listen on the same address and the
+     * kernel distributes new connections among them
      * @note set Non-blocking(by fd_event) and Reuse address for Eventloop use
      */
-    TcpAcceptor(const NetAddr::s_ptr paddr, int backlog = 1000);
+    TcpAcceptor(const NetAddr::s_ptr paddr, int backlog = 1000, bool reuse_port = false);
     ~TcpAcceptor();
 
-    // Accept a connection, return the client file descriptor
-    int accept(NetAddr &clientAddr);
+    /**
+     * @brief Accept a connection with accept4, return the client file descriptor
+     * @param flags accept4 flags for the new fd, e.g. SOCK_NONBLOCK | SOCK_CLOEXEC(no extra fcntl)
+     * @return -1: no pending connection(non-blocking listen fd, errno EAGAIN) or error
+     */
+    int accept(NetAddr &clientAddr, int flags = SOCK_CLOEXEC);
 
     // Get the listening file descriptor
     int getListenFd() const {
         return m_listenfd;
     }
 
+    /**
+     * @brief 为 SO_REUSEPORT 组挂载 CBPF 程序: 新连接分配给第 (处理该连接的 CPU % groups) 个 socket
+     * socket 在组中的序号为 listen 的顺序; IO 线程按序号绑定 CPU(io_thread_cpus)时，连接由处理其网卡队列中断的
+     * CPU 上的 IO 线程 accept
+     * @return false: 内核不支持(< 4.5)或者失败，使用内核默认的哈希分配
+     */
+    bool attachReusePortCpuSteering(int groups);
+
     // Get the address family
     int getFamily() const {
         return m_family;
@@ -14,18 +14,19 @@ public:
     using s_ptr = std::shared_ptr<TcpClient>;
 
 public:
-    TcpClient(NetAddr::s_ptr peer_addr);
+    // edge_triggered: 连接使用边缘触发(EPOLLET)模式
+    TcpClient(NetAddr::s_ptr peer_addr, bool edge_triggered = false);
     ~TcpClient();
 
     // 异步的连接远程地址 connect to peer_addr
     // 无论连接成功与否，会调用回调函数 conn_cb，上层根据错误码判断是否连接成功
-    void connect(std::function<void()> conn_cb);
+    void connect(Task conn_cb);
 
     // 异步的发送数据
-    void writeMessage(AbstractProtocol::s_ptr message, std::function<void(AbstractProtocol::s_ptr)> write_cb);
+    void writeMessage(AbstractProtocol::s_ptr message, TcpConnection::MessageCallback write_cb);
 
     // 异步的读取数据
-    void readMessage(const std::string &msg_id, std::function<void(AbstractProtocol::s_ptr)> read_cb);
+    void readMessage(const std::string &msg_id, TcpConnection::MessageCallback read_cb);
 
     // 关闭 EventLoop,关闭所有连接
     void close();
@@ -52,6 +53,8 @@ private:
 
     TcpConnection::s_ptr m_connection; // 连接对象
 
+    Task m_connect_cb; // 连接完成(成功或失败)后的回调函数
+
     int m_connect_error_code{0};      // 连接错误码
     std::string m_connect_error_info; // 连接错误信息
 };
@@ -7,10 +7,12 @@
 #include "rapidrpc/net/coder/abstract_protocol.h"
 #include "rapidrpc/net/coder/abstract_coder.h"
 #include "rapidrpc/net/rpc/dispatcher.h"
+#include "rapidrpc/common/inline_function.h"
 
 #include <vector>
 #include <map>
 #include <string>
+#include <memory>
 
 namespace rapidrpc {
 
@@ -20,15 +22,22 @@ enum class TcpConnectionType {
     TcpConnectionByClient = 2  // 客户端使用的连接
 };
 
-class TcpConnection {
+class TcpConnection: public std::enable_shared_from_this<TcpConnection> {
 public:
     using s_ptr = std::shared_ptr<TcpConnection>;
     using w_ptr = std::weak_ptr<TcpConnection>;
+    // 客户端读写消息后的回调函数
+    using MessageCallback = InlineFunction<void(AbstractProtocol::s_ptr)>;
 
 public:
     // TcpConnection(IOThread *io_thread, int fd, int buffer_size, NetAddr::s_ptr peer_addr);
+    /**
+     * @param edge_triggered: 边缘触发模式，读/写直到 EAGAIN，可读和可写事件一直注册，不再每条消息修改监听事件；
+     * EventLoop 的 Poller 不支持时使用水平触发
+     * @note 服务端连接的 fd 需要已经是非阻塞的(accept4 SOCK_NONBLOCK)
+     */
     TcpConnection(EventLoop *event_loop, int fd, int buffer_size, NetAddr::s_ptr peer_addr,
-                  TcpConnectionType conn_type = TcpConnectionType::TcpConnectionByServer);
+                  TcpConnectionType conn_type = TcpConnectionType::TcpConnectionByServer, bool edge_triggered = false);
 
     ~TcpConnection();
 
@@ -41,30 +50,58 @@ public:
     // write the response to socket
     void onWrite();
 
+    // socket error or peer hang up (EPOLLERR/EPOLLHUP), close the connection
+    void onError();
+
     void setState(const TcpState state);
     TcpState getState() const;
 
+    EventLoop *getEventLoop() const {
+        return m_event_loop;
+    }
+
     // 主动关闭无效的恶意连接
     // shutdwon the connection(unvalid tcp connection)
     void shutdown();
 
     // 设置连接关闭时的回调函数，绑定到 TcpServer::removeConnection，在创建连接后设置
-    void setRemoveConnCb(std::function<void()> &&remove_conn_cb);
+    void setRemoveConnCb(Task &&remove_conn_cb);
 
     // 监听可写事件，并重新加入到 epoll 中
+    // 边缘触发模式: 可写事件一直注册，直接尝试发送
     void listenWriteEvent();
 
     // 监听可读事件，并重新加入到 epoll 中
     void listenReadEvent();
 
     // client conn: 添加数据和回调函数到 m_write_cb 队列中，等待下次可写事件发生进行发送和执行回调函数
-    void addMessage(AbstractProtocol::s_ptr message, std::function<void(AbstractProtocol::s_ptr)> write_cb);
+    void addMessage(AbstractProtocol::s_ptr message, MessageCallback write_cb);
     // client conn: 添加请求 id 和回调函数到 m_read_cb 哈希表中，等待下次写读事件发生时读取并执行回调函数
-    void addReadCb(const std::string &msg_id, std::function<void(AbstractProtocol::s_ptr)> read_cb);
+    void addReadCb(const std::string &msg_id, MessageCallback read_cb);
 
     NetAddr::s_ptr getLocalAddr() const;
     NetAddr::s_ptr getPeerAddr() const;
 
+private:
+    // 关闭连接: 从 epoll 中删除，关闭 fd，并通知服务端删除连接
+    void clear();
+
+    // 边缘触发模式: 同时注册可读和可写事件(只注册一次)
+    void listenEdgeTriggered();
+
+    // 服务端: 在业务线程池中执行请求，响应在本连接的 IO 线程中发送; 队列已满返回 false
+    bool dispatchToWorker(AbstractProtocol::s_ptr request, AbstractProtocol::s_ptr response);
+
+    // 服务端: 编码响应写入发送缓冲区并监听可写事件, 在 IO 线程中调用
+    void reply(std::vector<AbstractProtocol::s_ptr> &responses);
+
+    // 在 IO 线程中分配输入/输出缓冲区
+    void initBuffers(int buffer_size);
+
+    // 更新 EventLoop 的负载计数(IOThreadPlacement 使用): 待发送字节数的变化 / 连接关闭
+    void updateQueuedBytes();
+    void releaseLoad();
+
 private:
     NetAddr::s_ptr m_local_addr;
     NetAddr::s_ptr m_peer_addr;
@@ -83,16 +120,23 @@ private:
 
     TcpState m_state; // 当前连接的状态
 
-    std::function<void()> m_remove_conn_cb; // 服务器端删除连接的回调函数
+    Task m_remove_conn_cb; // 服务器端删除连接的回调函数
 
     TcpConnectionType m_conn_type; // 连接类型，服务端连接或者客户端连接
 
+    bool m_edge_triggered{false}; // 是否边缘触发模式
+
+    int m_read_budget{0}; // 每次可读事件最多读取的字节数(Config::m_conn_read_budget), 0 不限制
+
     // 客户端写入的原始数据(由 m_coder 编码)和对应回调函数
-    std::vector<std::pair<AbstractProtocol::s_ptr, std::function<void(AbstractProtocol::s_ptr)>>> m_write_cb;
+    std::vector<std::pair<AbstractProtocol::s_ptr, MessageCallback>> m_write_cb;
     // 客户端读取时的请求 id 和回调函数
-    std::map<std::string, std::function<void(AbstractProtocol::s_ptr)>> m_read_cb;
+    std::map<std::string, MessageCallback> m_read_cb;
 
     AbstractCoder::s_ptr m_coder; // 编解码器
+
+    bool m_load_counted{false}; // 是否已经计入 EventLoop 的连接数(服务端连接)
+    int64_t m_queued_bytes{0};  // 已经计入 EventLoop 的待发送字节数
 };
 
 } // namespace rapidrpc
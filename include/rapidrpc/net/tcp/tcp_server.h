@@ -6,6 +6,8 @@
 #include "rapidrpc/net/io_thread_group.h"
 #include "rapidrpc/net/tcp/tcp_connection.h"
 #include <set>
+#include <mutex>
+#include <vector>
 
 namespace rapidrpc {
 
@@ -25,14 +27,72 @@ public:
      */
     void start();
 
+    /**
+     * @brief 新连接使用边缘触发(EPOLLET)模式，在 start() 之前调用
+     */
+    void setEdgeTriggered(bool value);
+
+    /**
+     * @brief 获取 SubReactor 线程组，例如读取各个 IO 线程的运行统计
+     */
+    IOThreadGroup *getIOThreadGroup() const;
+
+    /**
+     * @brief 是否每个 IO 线程使用自己的 SO_REUSEPORT 监听 socket(配置 accept_mode 为 reuseport/reuseport_cbpf)
+     */
+    bool isReusePort() const {
+        return !m_reuseport_acceptors.empty();
+    }
+
+    /**
+     * @brief 增加一个 IO 线程接收新连接, 可以在任意线程调用; SO_REUSEPORT 模式不支持(监听 socket 与线程一一对应)
+     * @return 新增(或者恢复的正在排空)的线程, 失败返回 nullptr
+     */
+    IOThread *addIOThread();
+
+    /**
+     * @brief 排空一个 IO 线程(nullptr 时选择连接数最少的): 不再分配新连接，已有连接关闭后由主线程定时器停止并释放线程
+     * 配置 io_drain_timeout_ms 时超时后关闭剩余的连接
+     * @return false: SO_REUSEPORT 模式, 只剩一个线程或者 thread 不在工作中
+     */
+    bool drainIOThread(IOThread *thread = nullptr);
+
     // 删除连接，由 TcpConnection 调用
     void removeConnection(TcpConnection::w_ptr conn);
 
 private:
     // 初始化 EventFd, 将 Acceptor 的 fd 添加到主Reactor的监听集合中
     void init();
-    // Acceptor 的回调函数，用于处理新连接
-    void onAccept();
+
+    /**
+     * @brief 每个 IO 线程创建一个 SO_REUSEPORT 的 Acceptor, 监听 fd 添加到该线程的 EventLoop
+     * 新连接由内核分配给某个 socket, 在对应的 IO 线程中 accept 并创建连接，不需要主线程转交
+     * @param cpu_steering: 挂载 CBPF 程序，按处理连接的 CPU 选择 socket
+     * @return false: 地址不支持(例如 Unix 域套接字), 使用主线程 accept
+     */
+    bool initReusePortAcceptors(bool cpu_steering);
+
+    /**
+     * @brief Acceptor 的回调函数，用于处理新连接
+     * 一次最多 accept 配置 accept_batch 个连接(取完 backlog), 分配给同一 IO 线程的连接合并为一个任务，只唤醒一次
+     * @param io_thread: 连接所在的 IO 线程, nullptr 时由 IOThreadGroup 的放置策略选择
+     */
+    void onAccept(TcpAcceptor::s_ptr acceptor, IOThread *io_thread);
+
+    // 在 event_loop 的线程中创建连接
+    void addConnection(EventLoop *event_loop, int client_fd, NetAddr::s_ptr client_addr);
+
+    /**
+     * @brief 主线程定时器回调: 自动调整 IO 线程数(配置 io_autoscale_interval_ms), 关闭排空超时的连接, 释放已排空的线程
+     * 没有开启自动调整时，所有排空的线程释放后删除定时器
+     */
+    void onResizeTimer();
+
+    // 在主线程中添加调整 IO 线程数的定时器(已经添加时不重复添加): 开启自动调整或者开始排空线程时
+    void armResizeTimer();
+
+    // 在 event_loop 的线程中关闭该线程上的所有连接
+    void closeConnections(EventLoop *event_loop);
 
 private:
     TcpAcceptor::s_ptr m_acceptor;
@@ -46,11 +106,19 @@ private:
     // 全局变量
     FdEvent *m_listen_fd_event{nullptr}; // 监听 fd 的事件
 
+    std::vector<TcpAcceptor::s_ptr> m_reuseport_acceptors; // SO_REUSEPORT 模式下第 i 个 IO 线程的 Acceptor
+
+    TimerEvent::s_ptr m_resize_timer; // 调整 IO 线程数的定时器(主线程), 不需要时为空
+
     int m_client_counts{0}; // 客户端连接数
 
+    int m_accept_batch{1}; // 每次可读事件最多 accept 的连接数
+
+    bool m_edge_triggered{false}; // 新连接是否使用边缘触发模式
+
     // 全局变量，用于保存所有的连接
     std::set<TcpConnection::s_ptr> m_connections;
-    std::mutex m_mutex; // 保护 m_connections
+    std::mutex m_mutex; // 保护 m_connections, m_client_counts(SO_REUSEPORT 模式下在多个 IO 线程中修改)
 };
 } // namespace rapidrpc
 
@@ -1,6 +1,7 @@
 /**
  * 定时器, 是一个定时任务的集合。同时它是 FdEvent，用于被 EventLoop 监听。
  * 主要目的是，管理所有的定时任务，当定时任务到期时，触发回调函数。
+ * 只在所属 EventLoop 的线程中访问，不加锁; 其他线程通过 EventLoop::addTimerEvent/deleteTimerEvent 转为 EventLoop 的任务
  */
 
 #ifndef RAPIDRPC_NET_TIMER_H
@@ -8,9 +9,12 @@
 
 #include "rapidrpc/net/fd_event.h"
 #include "rapidrpc/net/timer_event.h"
+#include "rapidrpc/net/timing_wheel.h"
+#include "rapidrpc/common/histogram.h"
 
 #include <map>
-#include <mutex>
+#include <atomic>
+#include <time.h>
 
 namespace rapidrpc {
 
@@ -22,12 +26,13 @@ public:
 
     /**
      * @brief 添加定时任务
-     * @param event: 定时任务
+     * @param event: 定时任务, 同时作为删除时的句柄(记录在定时任务集合中的位置)
+     * @note 一个 TimerEvent 同时只能添加到一个 Timer 中; 已经添加的任务会按新的到达时间重新放置
      */
     void addTimerEvent(TimerEvent::s_ptr event);
 
     /**
-     * @brief 移除定时任务
+     * @brief 移除定时任务, O(1): 立即释放任务捕获的变量以及 Timer 持有的引用
      * @param event: 定时任务
      */
     void deleteTimerEvent(TimerEvent::s_ptr event);
@@ -37,16 +42,87 @@ public:
      */
     void onTimer();
 
+    /**
+     * @brief 切换定时任务的存储方式，已有的定时任务会被迁移
+     * @param tick_ms: > 0 使用分层时间轮(添加/删除 O(1))，由周期为 tick_ms 的 timerfd 驱动，定时任务最多延迟一个 tick;
+     * 0 使用 std::multimap(默认)，timerfd 设置为最近的到达时间
+     * @note 在 EventLoop 线程中调用
+     */
+    void setTimingWheel(int64_t tick_ms);
+
+    /**
+     * @brief 设置定时器允许的延迟(us): timerfd 的唤醒时间向上取整到 slack_us 的整数倍，窗口内的到达时间共用一次唤醒
+     * @note 只对 std::multimap 模式生效，时间轮的精度由 tick 决定
+     */
+    void setSlack(int64_t slack_us);
+
+    /**
+     * @brief 重新设置 timerfd, EventLoop 每轮循环等待事件前调用一次
+     * @note 添加/删除定时任务只标记需要重新设置，同一轮中最早的到达时间多次变化只调用一次 timerfd_settime
+     */
+    void flushTimerfd();
+
+    /**
+     * @brief 定时任务实际执行时间与到达时间的差(us), 由 EventLoop 线程记录
+     */
+    const Histogram &getLagHistogram() const {
+        return m_lag_histogram;
+    }
+
+    /**
+     * @brief timerfd_settime 的调用次数
+     */
+    uint64_t getSettimeCalls() const {
+        return m_settime_calls.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 节省的 timerfd_settime 调用次数: 同一轮中合并的重新设置, 以及已经设置为更早的唤醒时间而跳过的设置
+     */
+    uint64_t getSettimeSaved() const {
+        return m_settime_saved.load(std::memory_order_relaxed);
+    }
+
 private:
+    /**
+     * @brief 标记需要重新设置 timerfd, 由 flushTimerfd 设置
+     */
+    void markReset();
+
     /**
      * @brief 重置定时器
+     * @note timerfd 已经设置为不晚于(取整后的)最早到达时间时不重新设置，提前唤醒时 onTimer 再设置
      */
     void resetTimer();
 
+    /**
+     * @brief 调用 timerfd_settime 并计数
+     */
+    int settime(int flags, const struct itimerspec *new_value);
+
+    // 节省一次 timerfd_settime 调用
+    void addSettimeSaved();
+
+    /**
+     * @brief 时间轮模式: 有定时任务时开启周期性的 timerfd，没有时关闭
+     */
+    void resetWheelTimer();
+
 private:
     // 定时任务集合
-    std::mutex m_mutex;
-    std::multimap<int64_t, TimerEvent::s_ptr> m_pending_events;
+    std::multimap<int64_t, TimerEvent::s_ptr> m_pending_events; // 到达时间(单调时钟 us) -> 定时任务
+
+    Histogram m_lag_histogram; // 定时器延迟
+
+    TimingWheel *m_wheel{nullptr}; // 时间轮, nullptr 时使用 m_pending_events
+    bool m_wheel_armed{false};     // 时间轮模式下周期性的 timerfd 是否开启
+
+    bool m_reset_pending{false}; // 是否需要重新设置 timerfd
+    int64_t m_armed_time{0};     // timerfd 设置的唤醒时间(单调时钟 us), 0 表示没有设置
+    int64_t m_slack_us{0};       // 允许的延迟(us)
+
+    std::atomic<uint64_t> m_settime_calls{0}; // timerfd_settime 调用次数
+    std::atomic<uint64_t> m_settime_saved{0}; // 节省的 timerfd_settime 调用次数
 };
 
 } // namespace rapidrpc
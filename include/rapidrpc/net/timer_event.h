@@ -5,9 +5,12 @@
 #ifndef RAPIDRPC_NET_TIMER_EVENT_H
 #define RAPIDRPC_NET_TIMER_EVENT_H
 
-#include <functional>
+#include "rapidrpc/common/inline_function.h"
+
 #include <memory>
-// #include <chrono>
+#include <list>
+#include <map>
+#include <chrono>
 
 namespace rapidrpc {
 
@@ -16,12 +19,20 @@ public:
     // typedef std::shared_ptr<TimerEvent> s_ptr;
     using s_ptr = std::shared_ptr<TimerEvent>;
 
-    TimerEvent(int interval, bool is_repeat, std::function<void()> cb);
+    /**
+     * @param interval: 间隔时间(ms)
+     */
+    TimerEvent(int interval, bool is_repeat, Task cb);
+
+    /**
+     * @param interval: 间隔时间(us), 用于亚毫秒级的超时，如 std::chrono::microseconds(300)
+     */
+    TimerEvent(std::chrono::microseconds interval, bool is_repeat, Task cb);
 
     ~TimerEvent();
 
     /**
-     * @brief 获取到达时间
+     * @brief 获取到达时间, 单调时钟(getMonotonicUs)的时间点, 单位 us
      */
     int64_t getArriveTime() const {
         return m_arrive_time;
@@ -41,19 +52,47 @@ public:
         return m_is_repeat;
     }
 
-    std::function<void()> getTask() const {
-        return m_task;
+    /**
+     * @brief 是否在 Timer 中等待到期(添加后，到期取出/删除前)
+     * @note 由 Timer 在 EventLoop 线程中维护
+     */
+    bool isPending() const {
+        return m_in_map || m_wheel_slot;
     }
 
-    void resetArriveTime();
+    /**
+     * @brief 执行任务
+     * @note 任务执行期间可能取消自身(setCanceled 会清空任务)，因此先移出再执行；
+     * 非重复任务执行后立即释放捕获的变量
+     */
+    void runTask();
+
+    /**
+     * @brief 重新计算到达时间: 当前时间 + 间隔
+     * @param precise: true 读取实时时钟, 用于新建的定时任务(同一轮中前面的任务可能已经执行了很久,
+     * 使用缓存的时间会提前到达); false 使用本轮循环缓存的时间, 用于到期后重新添加的重复任务
+     */
+    void resetArriveTime(bool precise = false);
 
 private:
-    int64_t m_arrive_time;     // 到达时间点/时间戳(ms), 可用于重复任务
-    int64_t m_interval;        // 间隔时间
+    int64_t m_arrive_time;     // 到达时间点(单调时钟 us), 不受系统时间调整的影响, 可用于重复任务
+    int64_t m_interval;        // 间隔时间(us)
     bool m_is_repeat{false};   // 是否重复
     bool m_is_canceled{false}; // 是否取消
 
-    std::function<void()> m_task; // 任务
+    Task m_task; // 任务
+
+    // 在 Timer 中的位置，用于 O(1) 删除: TimerEvent 自身就是定时任务的句柄
+    // 在 multimap 中的位置(由 Timer 维护), multimap 的迭代器在其他元素插入/删除时不会失效
+    friend class Timer;
+    std::multimap<int64_t, s_ptr>::iterator m_map_pos;
+    bool m_in_map{false};
+
+    // 在时间轮中的位置(由 TimingWheel 维护), m_wheel_slot 为 nullptr 时不在时间轮中
+    friend class TimingWheel;
+    std::list<s_ptr> *m_wheel_slot{nullptr};
+    std::list<s_ptr>::iterator m_wheel_pos;
+    int64_t m_wheel_tick{0}; // 到期的 tick
 };
 } // namespace rapidrpc
 
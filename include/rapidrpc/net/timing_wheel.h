@@ -0,0 +1,94 @@
+/**
+ * @file timing_wheel.h
+ * 分层时间轮，替代 Timer 中 std::multimap 保存的定时任务
+ * 1. 4 层: 第 0 层 256 个槽，每槽一个 tick；第 1~3 层各 64 个槽，每层每槽的跨度是下一层一圈的时间
+ *    覆盖 2^26 个 tick(1ms tick 约 18 小时)，更远的任务放在最高层最后，转动时重新放置
+ * 2. 添加/删除 O(1): 每个槽是一个链表，TimerEvent 记录自己所在的链表和位置
+ * 3. 每个 tick 处理第 0 层的一个槽；第 0 层转完一圈时，把上一层对应槽的任务重新放到下层(cascade)，
+ *    使用 std::list::splice 移动节点，不分配内存
+ * 只是数据结构，不加锁，只在所属 EventLoop 线程中访问，由 Timer 用周期性的 timerfd 驱动
+ */
+
+#ifndef RAPIDRPC_NET_TIMING_WHEEL_H
+#define RAPIDRPC_NET_TIMING_WHEEL_H
+
+#include "rapidrpc/net/timer_event.h"
+
+#include <list>
+#include <vector>
+#include <stdint.h>
+
+namespace rapidrpc {
+
+class TimingWheel {
+public:
+    /**
+     * @param tick_us: 每个 tick 的时间(us), 定时任务最多延迟一个 tick 执行
+     * @param now_us: 当前时间(单调时钟 us)，作为第 0 个 tick
+     */
+    TimingWheel(int64_t tick_us, int64_t now_us);
+
+    /**
+     * @brief 添加定时任务, 已经在时间轮中的任务会按新的到达时间重新放置
+     */
+    void add(TimerEvent::s_ptr event);
+
+    /**
+     * @brief 删除定时任务
+     * @return false: 不在时间轮中
+     */
+    bool remove(const TimerEvent::s_ptr &event);
+
+    /**
+     * @brief 转动时间轮到 now_us, 取出所有到期的任务(按到达的 tick 顺序)
+     */
+    void advance(int64_t now_us, std::vector<TimerEvent::s_ptr> &expired);
+
+    /**
+     * @brief 取出所有任务，用于切换回 multimap
+     */
+    void takeAll(std::vector<TimerEvent::s_ptr> &events);
+
+    size_t size() const {
+        return m_size;
+    }
+
+    int64_t getTickUs() const {
+        return m_tick_us;
+    }
+
+public:
+    static constexpr int ROOT_BITS = 8;  // 第 0 层 256 个槽
+    static constexpr int LEVEL_BITS = 6; // 第 1~3 层 64 个槽
+    static constexpr int LEVELS = 4;
+    static constexpr int ROOT_SIZE = 1 << ROOT_BITS;
+    static constexpr int LEVEL_SIZE = 1 << LEVEL_BITS;
+    static constexpr int64_t MAX_TICKS = (1LL << (ROOT_BITS + (LEVELS - 1) * LEVEL_BITS)) - 1;
+
+private:
+    using Slot = std::list<TimerEvent::s_ptr>;
+
+    // 根据到期 tick 选择槽
+    Slot *findSlot(int64_t expire_tick);
+
+    // 把任务(已经在某个链表中)移动到对应的槽
+    void place(Slot *from, Slot::iterator pos);
+
+    // 把第 level 层第 index 个槽的任务重新放到下层, 返回 index
+    int cascade(int level, int index);
+
+    int64_t toTick(int64_t time_us) const;
+
+private:
+    int64_t m_tick_us;
+    int64_t m_start_us;        // 第 0 个 tick 的时间
+    int64_t m_current_tick{0}; // 下一个要处理的 tick
+    size_t m_size{0};          // 任务数量
+
+    Slot m_root[ROOT_SIZE];
+    Slot m_levels[LEVELS - 1][LEVEL_SIZE];
+};
+
+} // namespace rapidrpc
+
+#endif // RAPIDRPC_NET_TIMING_WHEEL_H
@@ -21,7 +21,7 @@ public:
     ~WakeupFdEvent();
 
     // disable listen, automatically set read event/read callback in constructor
-    void listen(TriggerEvent event_type, std::function<void()> callback) = delete;
+    void listen(TriggerEvent event_type, Task callback) = delete;
 
     // bind fd with read callback
     void init();
@@ -17,6 +17,14 @@
     }                                                                                                                  \
     std::string name = std::string(name##_element->GetText());
 
+// 可选的配置项，不存在时使用默认值
+#define READ_OPT_STR_FROM_XML_NODE(name, parent, default_value)                                                        \
+    TiXmlElement *name##_element = parent->FirstChildElement(#name);                                                   \
+    std::string name = default_value;                                                                                  \
+    if (name##_element && name##_element->GetText()) {                                                                 \
+        name = std::string(name##_element->GetText());                                                                 \
+    }
+
 namespace rapidrpc {
 
 static Config *g_config = nullptr; // global config
@@ -41,6 +49,30 @@ void Config::SetGlobalConfig(const char *xmlfile) {
 Config::Config() {
     m_log_level = "DEBUG";
     m_log_type = LogType::SyncLog;
+    m_poller_type = "epoll";
+    m_io_thread_placement = "round_robin";
+    m_accept_mode = "main";
+    m_accept_batch = 64;
+    m_listen_backlog = 1000;
+    m_io_autoscale_interval_ms = 0;
+    m_io_threads_min = 1;
+    m_io_threads_max = 0;
+    m_io_autoscale_high_permille = 800;
+    m_io_autoscale_low_permille = 200;
+    m_io_drain_timeout_ms = 0;
+    m_io_thread_cpus = "";
+    m_main_thread_cpus = "";
+    m_busy_poll_us = 0;
+    m_so_busy_poll_us = 0;
+    m_loop_max_tasks = 0;
+    m_loop_max_task_us = 0;
+    m_conn_read_budget = 0;
+    m_worker_threads = 0;
+    m_worker_queue_size = 1024;
+    m_pooled_services = "";
+    m_worker_scheduler = "queue";
+    m_timer_wheel_tick_ms = 0;
+    m_timer_slack_us = 0;
 }
 
 Config::Config(const char *xmlfile) {
@@ -85,7 +117,70 @@ Config::Config(const char *xmlfile) {
     m_port = std::stoi(port);
     m_io_threads = std::stoi(io_threads);
 
-    printf("Server -- ip[%s], port[%d], io threads[%d]\n", m_ip.c_str(), m_port, m_io_threads);
+    READ_OPT_STR_FROM_XML_NODE(io_thread_placement, server_element, "round_robin");
+    m_io_thread_placement = std::move(io_thread_placement);
+    READ_OPT_STR_FROM_XML_NODE(accept_mode, server_element, "main");
+    m_accept_mode = std::move(accept_mode);
+    READ_OPT_STR_FROM_XML_NODE(accept_batch, server_element, "64");
+    READ_OPT_STR_FROM_XML_NODE(listen_backlog, server_element, "1000");
+    m_accept_batch = std::stoi(accept_batch);
+    m_listen_backlog = std::stoi(listen_backlog);
+    READ_OPT_STR_FROM_XML_NODE(io_autoscale_interval_ms, server_element, "0");
+    READ_OPT_STR_FROM_XML_NODE(io_threads_min, server_element, "1");
+    READ_OPT_STR_FROM_XML_NODE(io_threads_max, server_element, "0");
+    READ_OPT_STR_FROM_XML_NODE(io_autoscale_high_permille, server_element, "800");
+    READ_OPT_STR_FROM_XML_NODE(io_autoscale_low_permille, server_element, "200");
+    READ_OPT_STR_FROM_XML_NODE(io_drain_timeout_ms, server_element, "0");
+    m_io_autoscale_interval_ms = std::stoi(io_autoscale_interval_ms);
+    m_io_threads_min = std::stoi(io_threads_min);
+    m_io_threads_max = std::stoi(io_threads_max);
+    m_io_autoscale_high_permille = std::stoi(io_autoscale_high_permille);
+    m_io_autoscale_low_permille = std::stoi(io_autoscale_low_permille);
+    m_io_drain_timeout_ms = std::stoi(io_drain_timeout_ms);
+    READ_OPT_STR_FROM_XML_NODE(io_thread_cpus, server_element, "");
+    READ_OPT_STR_FROM_XML_NODE(main_thread_cpus, server_element, "");
+    m_io_thread_cpus = std::move(io_thread_cpus);
+    m_main_thread_cpus = std::move(main_thread_cpus);
+    READ_OPT_STR_FROM_XML_NODE(poller, server_element, "epoll");
+    m_poller_type = std::move(poller);
+    READ_OPT_STR_FROM_XML_NODE(busy_poll_us, server_element, "0");
+    READ_OPT_STR_FROM_XML_NODE(so_busy_poll_us, server_element, "0");
+    m_busy_poll_us = std::stoi(busy_poll_us);
+    m_so_busy_poll_us = std::stoi(so_busy_poll_us);
+
+    READ_OPT_STR_FROM_XML_NODE(loop_max_tasks, server_element, "0");
+    READ_OPT_STR_FROM_XML_NODE(loop_max_task_us, server_element, "0");
+    READ_OPT_STR_FROM_XML_NODE(conn_read_budget, server_element, "0");
+    m_loop_max_tasks = std::stoi(loop_max_tasks);
+    m_loop_max_task_us = std::stoi(loop_max_task_us);
+    m_conn_read_budget = std::stoi(conn_read_budget);
+    READ_OPT_STR_FROM_XML_NODE(worker_threads, server_element, "0");
+    READ_OPT_STR_FROM_XML_NODE(worker_queue_size, server_element, "1024");
+    READ_OPT_STR_FROM_XML_NODE(pooled_services, server_element, "");
+    READ_OPT_STR_FROM_XML_NODE(worker_scheduler, server_element, "queue");
+    m_worker_threads = std::stoi(worker_threads);
+    m_worker_queue_size = std::stoi(worker_queue_size);
+    m_pooled_services = std::move(pooled_services);
+    m_worker_scheduler = std::move(worker_scheduler);
+    READ_OPT_STR_FROM_XML_NODE(timer_wheel_tick_ms, server_element, "0");
+    m_timer_wheel_tick_ms = std::stoi(timer_wheel_tick_ms);
+    READ_OPT_STR_FROM_XML_NODE(timer_slack_us, server_element, "0");
+    m_timer_slack_us = std::stoi(timer_slack_us);
+
+    printf("Server -- ip[%s], port[%d], io threads[%d], poller[%s], busy poll[%dus], so_busy_poll[%dus]\n",
+           m_ip.c_str(), m_port, m_io_threads, m_poller_type.c_str(), m_busy_poll_us, m_so_busy_poll_us);
+    printf("Placement -- io thread placement[%s], accept mode[%s], io thread cpus[%s], main thread cpus[%s]\n",
+           m_io_thread_placement.c_str(), m_accept_mode.c_str(), m_io_thread_cpus.c_str(), m_main_thread_cpus.c_str());
+    printf("Accept -- accept batch[%d], listen backlog[%d]\n", m_accept_batch, m_listen_backlog);
+    printf("Autoscale -- interval[%dms], io threads min[%d], max[%d], high[%d permille], low[%d permille], drain "
+           "timeout[%dms]\n",
+           m_io_autoscale_interval_ms, m_io_threads_min, m_io_threads_max, m_io_autoscale_high_permille,
+           m_io_autoscale_low_permille, m_io_drain_timeout_ms);
+    printf("Budget -- loop max tasks[%d], loop max task time[%dus], conn read budget[%d bytes]\n", m_loop_max_tasks,
+           m_loop_max_task_us, m_conn_read_budget);
+    printf("Worker -- threads[%d], queue size[%d], pooled services[%s], scheduler[%s]\n", m_worker_threads,
+           m_worker_queue_size, m_pooled_services.c_str(), m_worker_scheduler.c_str());
+    printf("Timer -- timing wheel tick[%dms], slack[%dus]\n", m_timer_wheel_tick_ms, m_timer_slack_us);
     delete xml_document;
 }
 
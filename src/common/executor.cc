@@ -0,0 +1,18 @@
+#include "rapidrpc/common/executor.h"
+#include "rapidrpc/common/worker_pool.h"
+#include "rapidrpc/common/work_stealing_pool.h"
+#include "rapidrpc/common/log.h"
+
+namespace rapidrpc {
+
+Executor *Executor::Create(const std::string &type, int threads, int queue_size) {
+    if (type == "work_stealing") {
+        return new WorkStealingPool(threads, queue_size);
+    }
+    if (type != "queue") {
+        ERRORLOG("Unknown worker scheduler [%s], use queue", type.c_str());
+    }
+    return new WorkerPool(threads, queue_size);
+}
+
+} // namespace rapidrpc
@@ -0,0 +1,53 @@
+#include "rapidrpc/common/histogram.h"
+
+#include <stdio.h>
+
+namespace rapidrpc {
+
+double HistogramSnapshot::mean() const {
+    return m_count == 0 ? 0 : static_cast<double>(m_sum) / m_count;
+}
+
+uint64_t HistogramSnapshot::percentile(double p) const {
+    if (m_count == 0) {
+        return 0;
+    }
+    // 快照中各个桶的和可能与 m_count 不一致，以桶的和为准
+    uint64_t total = 0;
+    for (int i = 0; i < BUCKETS; i++) {
+        total += m_buckets[i];
+    }
+    uint64_t rank = static_cast<uint64_t>(p / 100 * total + 0.5);
+    if (rank == 0) {
+        rank = 1;
+    }
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKETS; i++) {
+        seen += m_buckets[i];
+        if (seen >= rank) {
+            uint64_t upper = i == 0 ? 0 : (i >= 63 ? UINT64_MAX : (1ULL << i) - 1);
+            return upper < m_max ? upper : m_max;
+        }
+    }
+    return m_max;
+}
+
+std::string HistogramSnapshot::toString() const {
+    char buf[128];
+    snprintf(buf, sizeof(buf), "count[%lu] mean[%.1f] p50[%lu] p99[%lu] max[%lu]", m_count, mean(), percentile(50),
+             percentile(99), m_max);
+    return buf;
+}
+
+HistogramSnapshot Histogram::snapshot() const {
+    HistogramSnapshot snapshot;
+    for (int i = 0; i < HistogramSnapshot::BUCKETS; i++) {
+        snapshot.m_buckets[i] = m_buckets[i].load(std::memory_order_relaxed);
+    }
+    snapshot.m_count = m_count.load(std::memory_order_relaxed);
+    snapshot.m_sum = m_sum.load(std::memory_order_relaxed);
+    snapshot.m_max = m_max.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+} // namespace rapidrpc
@@ -120,18 +120,27 @@ LogLevel logLevelFromString(const std::string &level) {
     }
 }
 
-std::string LogEvent::toString() {
-    struct timeval now_time; // sec and usec
-    gettimeofday(&now_time, nullptr);
-
-    struct tm localTime;                       // local time
-    localtime_r(&now_time.tv_sec, &localTime); // thread safe version of localtime
+// 同一秒内的日志复用格式化的时间字符串, 避免每条日志调用 localtime_r + strftime
+static thread_local time_t t_log_second = -1;
+static thread_local std::string t_log_second_str;
 
-    char buf[128];
-    strftime(buf, sizeof(buf), "%y-%m-%d %H:%M:%S", &localTime);
-    std::string time_str(buf);
+std::string LogEvent::toString() {
+    // EventLoop 线程中使用本轮循环缓存的时间
+    int64_t now_us = getCachedNowUs();
+    time_t now_sec = now_us / 1000000;
+
+    if (now_sec != t_log_second) {
+        struct tm localTime;               // local time
+        localtime_r(&now_sec, &localTime); // thread safe version of localtime
+
+        char buf[128];
+        strftime(buf, sizeof(buf), "%y-%m-%d %H:%M:%S", &localTime);
+        t_log_second = now_sec;
+        t_log_second_str = buf;
+    }
+    std::string time_str(t_log_second_str);
 
-    int ms = now_time.tv_usec / 1000;
+    int ms = (now_us % 1000000) / 1000;
     // to 3 digits
     time_str = time_str + "." + (ms < 10 ? "00" : (ms < 100 ? "0" : "")) + std::to_string(ms);
 
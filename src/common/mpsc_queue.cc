@@ -0,0 +1,49 @@
+#include "rapidrpc/common/mpsc_queue.h"
+
+namespace rapidrpc {
+
+MpscQueue::MpscQueue() : m_head(&m_stub), m_tail(&m_stub) {}
+
+void MpscQueue::push(Node *node) {
+    node->m_next.store(nullptr, std::memory_order_relaxed);
+    // 交换 head 后再链接到前一个节点，两步之间消费者会看到一个"断开"的链表
+    Node *prev = m_head.exchange(node, std::memory_order_acq_rel);
+    prev->m_next.store(node, std::memory_order_release);
+}
+
+MpscQueue::Node *MpscQueue::pop() {
+    Node *tail = m_tail;
+    Node *next = tail->m_next.load(std::memory_order_acquire);
+    // 跳过哨兵节点
+    if (tail == &m_stub) {
+        if (!next) {
+            return nullptr;
+        }
+        m_tail = next;
+        tail = next;
+        next = next->m_next.load(std::memory_order_acquire);
+    }
+    if (next) {
+        m_tail = next;
+        return tail;
+    }
+    // tail 是最后一个可见节点: 如果 head 已经改变，说明有生产者正在 push
+    Node *head = m_head.load(std::memory_order_acquire);
+    if (tail != head) {
+        return nullptr;
+    }
+    // 重新放入哨兵节点，保证 tail 取出后队列仍有一个节点
+    push(&m_stub);
+    next = tail->m_next.load(std::memory_order_acquire);
+    if (next) {
+        m_tail = next;
+        return tail;
+    }
+    return nullptr;
+}
+
+bool MpscQueue::empty() const {
+    return m_tail == &m_stub && m_head.load(std::memory_order_acquire) == &m_stub;
+}
+
+} // namespace rapidrpc
@@ -2,7 +2,11 @@
 
 #include <sys/syscall.h>
 #include <sys/time.h>
+#include <linux/mempolicy.h>
+#include <pthread.h>
+#include <sched.h>
 #include <errno.h>
+#include <stdlib.h>
 #include <time.h>
 
 namespace rapidrpc {
@@ -76,6 +80,49 @@ int64_t getNowMs() {
     return now;
 }
 
+int64_t getMonotonicUs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+int64_t getMonotonicNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+// 0 表示没有缓存
+static thread_local int64_t t_cached_monotonic_us = 0;
+static thread_local int64_t t_cached_now_us = 0;
+
+void updateCachedClock(int64_t monotonic_us) {
+    t_cached_monotonic_us = monotonic_us;
+    t_cached_now_us = 0;
+}
+
+void clearCachedClock() {
+    t_cached_monotonic_us = 0;
+    t_cached_now_us = 0;
+}
+
+int64_t getCachedMonotonicUs() {
+    return t_cached_monotonic_us ? t_cached_monotonic_us : getMonotonicUs();
+}
+
+int64_t getCachedNowUs() {
+    if (t_cached_now_us) {
+        return t_cached_now_us;
+    }
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+    int64_t now = (int64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+    if (t_cached_monotonic_us) {
+        t_cached_now_us = now;
+    }
+    return now;
+}
+
 // for debug log
 std::string getFormatTime(int64_t ms) {
 
@@ -99,4 +146,63 @@ std::string getFormatTime(int64_t ms) {
     return result;
 }
 
+std::vector<int> parseCpuList(const std::string &cpus) {
+    std::vector<int> result;
+    size_t pos = 0;
+    while (pos < cpus.size()) {
+        size_t end = cpus.find(',', pos);
+        if (end == std::string::npos) {
+            end = cpus.size();
+        }
+        std::string item = cpus.substr(pos, end - pos);
+        pos = end + 1;
+        if (item.empty()) {
+            continue;
+        }
+        // 单个 CPU 或者范围 first-last
+        char *next = nullptr;
+        long first = strtol(item.c_str(), &next, 10);
+        long last = first;
+        if (*next == '-') {
+            last = strtol(next + 1, &next, 10);
+        }
+        if (*next != '\0' || first < 0 || last < first || last >= CPU_SETSIZE) {
+            return {};
+        }
+        for (long cpu = first; cpu <= last; cpu++) {
+            result.push_back(static_cast<int>(cpu));
+        }
+    }
+    return result;
+}
+
+bool setThreadAffinity(const std::vector<int> &cpus) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) {
+        CPU_SET(cpu, &set);
+    }
+    int rt = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (rt != 0) {
+        errno = rt;
+        return false;
+    }
+    return true;
+}
+
+void setThreadName(const std::string &name) {
+    // 包括结尾的 '\0' 最多 16 个字符, 截断前缀保留序号，同一组的线程名称不会相同
+    const size_t max_len = 15;
+    std::string short_name = name.substr(0, max_len);
+    size_t pos = name.rfind('-');
+    if (name.size() > max_len && pos != std::string::npos && name.size() - pos < max_len) {
+        short_name = name.substr(0, max_len - (name.size() - pos)) + name.substr(pos);
+    }
+    pthread_setname_np(pthread_self(), short_name.c_str());
+}
+
+bool setLocalMemoryPolicy() {
+    return syscall(SYS_set_mempolicy, MPOL_LOCAL, nullptr, 0) == 0;
+}
+
 } // namespace rapidrpc
\ No newline at end of file
@@ -0,0 +1,188 @@
+#include "rapidrpc/common/work_stealing_pool.h"
+#include "rapidrpc/common/util.h"
+
+#include <string>
+
+namespace rapidrpc {
+
+// 当前线程是哪个线程池的业务线程
+static thread_local WorkStealingPool *t_worker_pool = nullptr;
+static thread_local int t_worker_index = -1;
+
+// 外部线程(IO 线程)提交任务时固定放入的业务线程
+// 按线程池的 id 而不是地址记录: 线程池释放后新的线程池可能复用同一个地址, 业务线程数可能更少
+static thread_local uint64_t t_home_pool_id = 0;
+static thread_local int t_home_index = -1;
+
+// 线程池的 id 从 1 开始, 0 表示没有记录
+static std::atomic<uint64_t> g_next_pool_id{1};
+
+WorkStealingPool::WorkStealingPool(int threads, int queue_size)
+    : m_id(g_next_pool_id.fetch_add(1, std::memory_order_relaxed)),
+      m_max_queue_size(queue_size > 0 ? queue_size : 0) {
+    if (threads <= 0) {
+        threads = 1;
+    }
+    m_workers.reserve(threads);
+    for (int i = 0; i < threads; i++) {
+        m_workers.emplace_back(new Worker());
+        m_workers.back()->m_random = 0x9E3779B97F4A7C15ULL * (i + 1);
+    }
+    // 所有 Worker 创建完成后再启动线程, 线程中会访问其他 Worker
+    for (int i = 0; i < threads; i++) {
+        m_workers[i]->m_thread = std::thread(&WorkStealingPool::run, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    stop();
+}
+
+bool WorkStealingPool::submit(Task task) {
+    // 先增加计数再检查 m_stop: 业务线程在 m_pending 为 0 之前不会退出，已经接受的任务一定会被执行
+    int64_t pending = m_pending.fetch_add(1);
+    if (m_stop.load() || (m_max_queue_size > 0 && pending >= static_cast<int64_t>(m_max_queue_size))) {
+        m_pending.fetch_sub(1);
+        m_rejected.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    Task *item = new Task(std::move(task));
+    if (t_worker_pool == this) {
+        m_workers[t_worker_index]->m_deque.push(item);
+    }
+    else {
+        if (t_home_pool_id != m_id) {
+            t_home_pool_id = m_id;
+            t_home_index = m_next_home.fetch_add(1, std::memory_order_relaxed) % m_workers.size();
+        }
+        Worker *home = m_workers[t_home_index].get();
+        std::lock_guard<std::mutex> lock(home->m_inbox_mutex);
+        home->m_inbox.push_back(item);
+    }
+
+    // 与 run 中的 m_sleepers/m_pending 检查配合，不会丢失唤醒
+    if (m_sleepers.load() > 0) {
+        std::lock_guard<std::mutex> lock(m_sleep_mutex);
+        m_sleep_cond.notify_one();
+    }
+    return true;
+}
+
+void WorkStealingPool::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_sleep_mutex);
+        if (m_stop.load()) {
+            return;
+        }
+        m_stop.store(true);
+    }
+    m_sleep_cond.notify_all();
+    for (auto &worker : m_workers) {
+        if (worker->m_thread.joinable()) {
+            worker->m_thread.join();
+        }
+    }
+}
+
+uint64_t WorkStealingPool::getStolen() const {
+    uint64_t stolen = 0;
+    for (auto &worker : m_workers) {
+        stolen += worker->m_stolen.load(std::memory_order_relaxed);
+    }
+    return stolen;
+}
+
+void WorkStealingPool::run(int index) {
+    t_worker_pool = this;
+    t_worker_index = index;
+    setThreadName("rapidrpc-worker-" + std::to_string(index));
+
+    while (true) {
+        Task *task = findTask(index);
+        if (task) {
+            m_pending.fetch_sub(1);
+            if (*task) {
+                (*task)();
+            }
+            delete task;
+            continue;
+        }
+        if (m_pending.load() > 0) {
+            // 任务正在被提交, 或者收件箱正被其他线程加锁
+            std::this_thread::yield();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_sleep_mutex);
+        m_sleepers.fetch_add(1);
+        while (m_pending.load() == 0 && !m_stop.load()) {
+            m_sleep_cond.wait(lock);
+        }
+        m_sleepers.fetch_sub(1);
+        if (m_stop.load() && m_pending.load() == 0) {
+            // 已经停止并且任务已经执行完
+            return;
+        }
+    }
+}
+
+Task *WorkStealingPool::findTask(int index) {
+    Worker *worker = m_workers[index].get();
+    Task *task = worker->m_deque.take();
+    if (task) {
+        return task;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(worker->m_inbox_mutex);
+        // 倒序放入: 本线程 take(队尾)先执行先提交的任务, 窃取者(队首)取走后提交的任务
+        for (auto it = worker->m_inbox.rbegin(); it != worker->m_inbox.rend(); ++it) {
+            worker->m_deque.push(*it);
+        }
+        worker->m_inbox.clear();
+    }
+    task = worker->m_deque.take();
+    if (task) {
+        return task;
+    }
+    return steal(index);
+}
+
+Task *WorkStealingPool::steal(int index) {
+    size_t n = m_workers.size();
+    if (n <= 1) {
+        return nullptr;
+    }
+    Worker *self = m_workers[index].get();
+    for (size_t attempt = 0; attempt < 2 * n; attempt++) {
+        // xorshift64
+        uint64_t x = self->m_random;
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        self->m_random = x;
+        size_t victim_index = x % n;
+        if (victim_index == static_cast<size_t>(index)) {
+            continue;
+        }
+
+        Worker *victim = m_workers[victim_index].get();
+        Task *task = victim->m_deque.steal();
+        if (!task) {
+            // 所有者正在执行耗时的任务, 收件箱中的任务还没有放入它的队列
+            std::unique_lock<std::mutex> lock(victim->m_inbox_mutex, std::try_to_lock);
+            if (lock.owns_lock() && !victim->m_inbox.empty()) {
+                task = victim->m_inbox.front();
+                victim->m_inbox.pop_front();
+            }
+        }
+        if (task) {
+            self->m_stolen.fetch_add(1, std::memory_order_relaxed);
+            return task;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace rapidrpc
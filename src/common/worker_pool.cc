@@ -0,0 +1,73 @@
+#include "rapidrpc/common/worker_pool.h"
+#include "rapidrpc/common/util.h"
+
+#include <string>
+
+namespace rapidrpc {
+
+WorkerPool::WorkerPool(int threads, int queue_size) : m_max_queue_size(queue_size > 0 ? queue_size : 0) {
+    m_threads.reserve(threads);
+    for (int i = 0; i < threads; i++) {
+        m_threads.emplace_back(&WorkerPool::run, this, i);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    stop();
+}
+
+bool WorkerPool::submit(Task task) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stop || (m_max_queue_size > 0 && m_tasks.size() >= m_max_queue_size)) {
+            m_rejected.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        m_tasks.push_back(std::move(task));
+    }
+    m_cond.notify_one();
+    return true;
+}
+
+void WorkerPool::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stop) {
+            return;
+        }
+        m_stop = true;
+    }
+    m_cond.notify_all();
+    for (auto &thread : m_threads) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+}
+
+size_t WorkerPool::getQueueSize() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_tasks.size();
+}
+
+void WorkerPool::run(int index) {
+    setThreadName("rapidrpc-worker-" + std::to_string(index));
+    while (true) {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cond.wait(lock, [this]() { return m_stop || !m_tasks.empty(); });
+            if (m_tasks.empty()) {
+                // m_stop 并且任务已经执行完
+                return;
+            }
+            task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+        }
+        if (task) {
+            task();
+        }
+    }
+}
+
+} // namespace rapidrpc
@@ -0,0 +1,79 @@
+#include "rapidrpc/net/epoll_poller.h"
+#include "rapidrpc/common/log.h"
+
+#include <unistd.h>
+#include <string.h>
+
+namespace rapidrpc {
+
+EpollPoller::EpollPoller() {
+    m_epoll_fd = epoll_create(100);
+    if (m_epoll_fd < 0) {
+        ERRORLOG("Failed to create epoll fd, error [%s]", strerror(errno));
+        exit(-1);
+    }
+}
+
+EpollPoller::~EpollPoller() {
+    if (m_epoll_fd >= 0) {
+        close(m_epoll_fd);
+    }
+}
+
+void EpollPoller::setListening(int fd, bool value) {
+    size_t index = static_cast<size_t>(fd) / 64;
+    if (index >= m_listen_fds.size()) {
+        if (!value) {
+            return;
+        }
+        m_listen_fds.resize(index + 1 > 2 * m_listen_fds.size() ? index + 1 : 2 * m_listen_fds.size(), 0);
+    }
+    if (value) {
+        m_listen_fds[index] |= (1ULL << (fd % 64));
+    }
+    else {
+        m_listen_fds[index] &= ~(1ULL << (fd % 64));
+    }
+}
+
+bool EpollPoller::addEvent(FdEvent *event) {
+    int fd = event->getFd();
+    if (fd < 0) {
+        return false;
+    }
+    int op = isListening(fd) ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+    epoll_event ev = event->getEpollEvent();
+    int rt = epoll_ctl(m_epoll_fd, op, fd, &ev);
+    // fd 关闭后内核已经自动删除(位图中仍然存在)，或者 fd 被复用
+    if (rt < 0 && op == EPOLL_CTL_MOD && errno == ENOENT) {
+        op = EPOLL_CTL_ADD;
+        rt = epoll_ctl(m_epoll_fd, op, fd, &ev);
+    }
+    if (rt < 0) {
+        ERRORLOG("Failed to add fd_event[fd=%d] to epoll, error [%s]", fd, strerror(errno));
+        return false;
+    }
+    setListening(fd, true);
+    DEBUGLOG("Add fd_event[fd=%d] to epoll(%s)", fd, (op == EPOLL_CTL_ADD ? "ADD" : "MOD"));
+    return true;
+}
+
+void EpollPoller::deleteEvent(FdEvent *event) {
+    int fd = event->getFd();
+    if (fd < 0 || !isListening(fd)) {
+        return;
+    }
+    int rt = epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+    // fd 已经关闭时内核已经自动删除
+    if (rt < 0 && errno != EBADF && errno != ENOENT) {
+        ERRORLOG("Failed to delete epoll event, error [%s]", strerror(errno));
+    }
+    setListening(fd, false);
+    DEBUGLOG("Delete epoll event, fd [%d]", fd);
+}
+
+int EpollPoller::poll(epoll_event *events, int max_events, int timeout_ms) {
+    return epoll_wait(m_epoll_fd, events, max_events, timeout_ms);
+}
+
+} // namespace rapidrpc
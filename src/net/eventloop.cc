@@ -1,50 +1,37 @@
 #include "rapidrpc/net/eventloop.h"
 #include "rapidrpc/common/log.h"
 #include "rapidrpc/common/util.h"
+#include "rapidrpc/common/config.h"
 
 #include <sys/socket.h>
 #include <sys/epoll.h>
 #include <sys/eventfd.h>
 #include <string.h>
-
-// micro to add epoll event
-// with local variable (it,op,ev,rt)
-#define ADD_TO_EPOLL(event, m_epoll_fd)                                                                                \
-    auto it = m_listen_fds.find(event->getFd());                                                                       \
-    int op = EPOLL_CTL_ADD;                                                                                            \
-    if (it != m_listen_fds.end()) {                                                                                    \
-        op = EPOLL_CTL_MOD;                                                                                            \
-    }                                                                                                                  \
-    else {                                                                                                             \
-        m_listen_fds.insert(event->getFd());                                                                           \
-    }                                                                                                                  \
-    epoll_event ev = event->getEpollEvent();                                                                           \
-    int rt = epoll_ctl(m_epoll_fd, op, event->getFd(), &ev);                                                           \
-    if (rt < 0) {                                                                                                      \
-        ERRORLOG("Failed to add fd_event[fd=%d] to epoll, error [%s]", event->getFd(), strerror(errno));               \
-    }                                                                                                                  \
-    else                                                                                                               \
-        DEBUGLOG("Add fd_event[fd=%d] to epoll(%s)", event->getFd(), (op == EPOLL_CTL_ADD ? "ADD" : "MOD"));
-
-// micro to delete epoll event
-// with local variable (it,rt)
-#define DELETE_FROM_EPOLL(event, m_epoll_fd)                                                                           \
-    auto it = m_listen_fds.find(event->getFd());                                                                       \
-    if (it != m_listen_fds.end()) {                                                                                    \
-        int rt = epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, event->getFd(), nullptr);                                        \
-        if (rt < 0) {                                                                                                  \
-            ERRORLOG("Failed to delete epoll event, error [%s]", strerror(errno));                                     \
-        }                                                                                                              \
-        m_listen_fds.erase(it);                                                                                        \
-        DEBUGLOG("Delete epoll event, fd [%d]", event->getFd());                                                       \
-    }
+#include <algorithm>
 
 namespace rapidrpc {
 
+// 任务队列的节点
+struct PendingTask: public MpscQueue::Node {
+    explicit PendingTask(Task &&cb) : m_cb(std::move(cb)) {}
+    Task m_cb;
+};
+
 // * 每个线程最多一个 EventLoop, thread local 变量
 static thread_local EventLoop *t_current_loop = nullptr;
 static int g_epoll_max_timeout = 10000;
-static int g_epoll_max_events = 10;
+static size_t g_epoll_init_events = 16;   // epoll_wait 返回事件数组的初始大小
+static size_t g_epoll_max_events = 4096;  // 返回事件数组的最大大小, 每次填满时扩大一倍
+static int64_t g_busy_poll_min_us = 10;   // 自适应自旋时间的下限，小于该值时直接阻塞
+static double g_busy_window_us = 100000;  // 繁忙比例的加权窗口(us)
+
+static inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
 
 // 1. 添加 m_wakeup_fd 到 epoll 中
 // 2. 打印 EventLoop 创建信息
@@ -57,22 +44,25 @@ EventLoop::EventLoop() {
     }
 
     m_tid = getThreadId();
-    m_epoll_fd = epoll_create(100);
-    if (m_epoll_fd < 0) {
-        ERRORLOG("Failed to create epoll fd, error [%s]", strerror(errno));
-        exit(-1);
-    }
+    m_result_events.resize(g_epoll_init_events);
+    // 根据配置选择 Poller, 默认 epoll
+    m_poller = Poller::Create(Config::GetGlobalConfig() ? Config::GetGlobalConfig()->m_poller_type : "epoll");
 
     initWakeupFdEvent(); // 添加 m_wakeup_fd 到 epoll 中
     initTimer();         // 添加定时器 m_Timer 到 epoll 中
+    if (Config::GetGlobalConfig() && Config::GetGlobalConfig()->m_timer_wheel_tick_ms > 0) {
+        setTimingWheel(Config::GetGlobalConfig()->m_timer_wheel_tick_ms);
+    }
+    if (Config::GetGlobalConfig() && Config::GetGlobalConfig()->m_timer_slack_us > 0) {
+        setTimerSlack(Config::GetGlobalConfig()->m_timer_slack_us);
+    }
 
-    INFOLOG("EventLoop created in thread %d", m_tid);
+    INFOLOG("EventLoop created in thread %d, poller [%s]", m_tid, m_poller->getName());
     t_current_loop = this;
 }
 
 EventLoop::~EventLoop() {
     // TODO : close all listen fds
-    close(m_epoll_fd);
     if (m_wakeup_event) {
         delete m_wakeup_event;
         m_wakeup_event = nullptr;
@@ -81,6 +71,18 @@ EventLoop::~EventLoop() {
         delete m_timer;
         m_timer = nullptr;
     }
+    if (m_poller) {
+        delete m_poller;
+        m_poller = nullptr;
+    }
+    // 释放未执行的任务
+    for (size_t i = m_task_batch_index; i < m_task_batch.size(); i++) {
+        delete static_cast<PendingTask *>(m_task_batch[i]);
+    }
+    MpscQueue::Node *node = nullptr;
+    while ((node = m_pending_tasks.pop()) != nullptr) {
+        delete static_cast<PendingTask *>(node);
+    }
 }
 
 void EventLoop::initWakeupFdEvent() {
@@ -106,68 +108,233 @@ void EventLoop::initTimer() {
 
 void EventLoop::loop() {
     m_is_looping = true;
+    // 每轮循环读取三次时钟: 执行任务前(上一轮结束时)、等待事件前、等待事件后
+    // 执行任务前和等待事件后的时间同时刷新线程的缓存时钟, 任务/事件回调中的定时器、日志读取缓存的时间
+    int64_t task_start = getMonotonicUs();
     while (!m_stop_flag) {
-        // 处理并清空任务队列，避免循环前队列不为空
-        std::queue<std::function<void()>> tasks;
-        {
-            std::lock_guard<std::mutex> lock(m_mutex);
-            tasks.swap(m_pending_tasks);
-        }
+        updateCachedClock(task_start);
+        // 处理并清空任务队列，避免循环前队列不为空(超出预算时剩余的任务下一轮执行)
+        runPendingTasks();
+        // 本轮(上一轮事件回调和本轮任务)中添加/删除定时任务后，只重新设置一次 timerfd
+        m_timer->flushTimerfd();
+        int64_t poll_start = getMonotonicUs();
 
-        while (!tasks.empty()) {
-            // null check: 避免触发了非预期的事件，获取的回调函数是空的
-            std::function<void()> cb(std::move(tasks.front()));
-            tasks.pop();
-            if (cb) {
-                cb();
+        // 自旋模式: 先以 0 超时轮询，自旋期间不需要 wakeup fd 唤醒
+        int rt = 0;
+        if (m_busy_poll_us > 0 && m_task_batch_index == m_task_batch.size()) {
+            rt = busyPoll();
+        }
+        if (rt == 0) {
+            // 先标记即将阻塞，再检查任务队列和停止标记，与 wakeup() 配对:
+            // 要么这里看到新任务/停止标记而不阻塞，要么 wakeup() 看到 m_sleeping 而写 wakeup fd
+            m_sleeping.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int timeout = g_epoll_max_timeout;
+            if (hasPendingTasks() || m_stop_flag.load(std::memory_order_relaxed)) {
+                timeout = 0;
+            }
+            int64_t wait_start = m_busy_poll_max_us > 0 ? getMonotonicUs() : 0;
+            rt = m_poller->poll(m_result_events.data(), static_cast<int>(m_result_events.size()), timeout);
+            m_sleeping.store(false, std::memory_order_relaxed);
+            // 阻塞后很快就有事件到达，说明自旋可以等到，恢复最大自旋时间
+            if (m_busy_poll_max_us > 0 && rt > 0 && getMonotonicUs() - wait_start < m_busy_poll_max_us) {
+                m_busy_poll_us = m_busy_poll_max_us;
             }
         }
 
-        int timeout = g_epoll_max_timeout;
-        epoll_event result_events[g_epoll_max_events]; // return events
-        int rt = epoll_wait(m_epoll_fd, result_events, g_epoll_max_events, timeout);
+        int64_t poll_end = getMonotonicUs();
+        updateCachedClock(poll_end);
+        m_poll_wait_hist.record(poll_end - poll_start);
 
         if (rt < 0) {
-            ERRORLOG("epoll_wait error, error [%s]", strerror(errno));
+            if (errno != EINTR) {
+                ERRORLOG("epoll_wait error, error [%s]", strerror(errno));
+            }
+            task_start = poll_end;
             continue;
         }
-        else { // 0: timeout, >0: events
-            for (int i = 0; i < rt; i++) {
-                epoll_event trigger_event = result_events[i];
-                FdEvent *fd_event = static_cast<FdEvent *>(trigger_event.data.ptr);
-                if (!fd_event)
-                    continue;
-                // 可读事件
-                if (trigger_event.events & EPOLLIN) {
-                    // add task
-                    auto tmp = fd_event->getHandler(TriggerEvent::IN_EVENT);
-                    addTask(fd_event->getHandler(TriggerEvent::IN_EVENT));
-                    DEBUGLOG("%s[%d] trigger IN event",
-                             (fd_event->getFd() == m_timer->getFd()
-                                  ? "Timer fd"
-                                  : (fd_event->getFd() == m_wakeup_event->getFd() ? "Wakeup fd" : "fd")),
-                             fd_event->getFd());
-                }
-                // 可写事件
-                else if (trigger_event.events & EPOLLOUT) {
-                    // add task
-                    auto tmp = fd_event->getHandler(TriggerEvent::OUT_EVENT);
-                    addTask(fd_event->getHandler(TriggerEvent::OUT_EVENT));
-                    DEBUGLOG("fd[%d] trigger OUT event", fd_event->getFd());
+        m_ready_events_hist.record(rt);
+        // 0: timeout, >0: events
+        for (int i = 0; i < rt; i++) {
+            uint32_t generation = 0;
+            FdEvent *fd_event = FdEvent::DecodeEpollData(m_result_events[i].data.u64, &generation);
+            if (!fd_event)
+                continue;
+            if (fd_event == m_wakeup_event) {
+                handleWakeUp();
+                continue;
+            }
+            // 同一批事件中前面的回调关闭了该 fd，并且 fd 已经被新连接复用(同一个 FdEvent)，丢弃旧连接的事件
+            if (fd_event->isStale(generation)) {
+                m_stale_events.store(m_stale_events.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                continue;
+            }
+            uint32_t revents = m_result_events[i].events;
+            // 可读事件
+            if (revents & EPOLLIN) {
+                DEBUGLOG("%s[%d] trigger IN event",
+                         (fd_event->getFd() == m_timer->getFd()
+                              ? "Timer fd"
+                              : (fd_event->getFd() == m_wakeup_event->getFd() ? "Wakeup fd" : "fd")),
+                         fd_event->getFd());
+                dispatchEvent(fd_event, TriggerEvent::IN_EVENT);
+            }
+            // 可写事件, 与可读事件在同一次唤醒中处理
+            if (revents & EPOLLOUT) {
+                DEBUGLOG("fd[%d] trigger OUT event", fd_event->getFd());
+                dispatchEvent(fd_event, TriggerEvent::OUT_EVENT);
+            }
+            // 出错，或者对端挂断且没有数据可读（有数据时由读回调读到 EOF 后关闭）
+            // 连接失败时 EPOLLERR/EPOLLHUP 会与 EPOLLOUT 同时触发，由写回调处理
+            if ((revents & EPOLLERR) || ((revents & EPOLLHUP) && !(revents & EPOLLIN))) {
+                if (fd_event->isListening(TriggerEvent::ERROR_EVENT)) {
+                    DEBUGLOG("fd[%d] trigger ERROR event[%u]", fd_event->getFd(), revents);
+                    dispatchEvent(fd_event, TriggerEvent::ERROR_EVENT);
                 }
-                // 其它事件，例如 EPOLLERR, EPOLLHUP（连接失败会与 EPOLLOUT 同时触发）
-                else {
-                    INFOLOG("fd[%d] trigger other event[%u]", fd_event->getFd(),
-                            static_cast<unsigned int>(trigger_event.events));
+                else if (!(revents & (EPOLLIN | EPOLLOUT))) {
+                    INFOLOG("fd[%d] trigger other event[%u]", fd_event->getFd(), revents);
                 }
             }
         }
+        // 事件数组被填满，扩大一倍，减少下一轮 epoll_wait 的次数
+        if (static_cast<size_t>(rt) == m_result_events.size() && m_result_events.size() < g_epoll_max_events) {
+            m_result_events.resize(m_result_events.size() * 2);
+        }
+        int64_t handler_end = getMonotonicUs();
+        int64_t busy_us = (poll_start - task_start) + (handler_end - poll_end);
+        m_handler_hist.record(busy_us);
+        updateBusyRatio(busy_us, handler_end - task_start);
+        task_start = handler_end;
+    }
+    // 退出循环后缓存不再刷新
+    clearCachedClock();
+}
+
+// 按本轮时间加权: 长时间阻塞后(本轮超过窗口)直接使用本轮的占比
+void EventLoop::updateBusyRatio(int64_t busy_us, int64_t total_us) {
+    if (total_us <= 0) {
+        return;
+    }
+    double alpha = std::min(1.0, static_cast<double>(total_us) / g_busy_window_us);
+    m_busy_ratio += alpha * (static_cast<double>(busy_us) / total_us - m_busy_ratio);
+    m_busy_permille.store(static_cast<int>(m_busy_ratio * 1000), std::memory_order_relaxed);
+}
+
+void EventLoop::runPendingTasks() {
+    // 先取出当前已有的全部任务，等价于原来加锁 swap 整个队列
+    // 上一轮超出预算剩余的任务在前面，保持执行顺序
+    MpscQueue::Node *node = nullptr;
+    while ((node = m_pending_tasks.pop()) != nullptr) {
+        m_task_batch.push_back(node);
+    }
+    m_queue_depth_hist.record(m_task_batch.size() - m_task_batch_index);
+    size_t end = m_task_batch.size();
+    if (m_task_budget_max > 0 && end - m_task_batch_index > static_cast<size_t>(m_task_budget_max)) {
+        end = m_task_batch_index + m_task_budget_max;
+    }
+    int64_t deadline = m_task_budget_max_us > 0 ? getCachedMonotonicUs() + m_task_budget_max_us : 0;
+    while (m_task_batch_index < end) {
+        PendingTask *task = static_cast<PendingTask *>(m_task_batch[m_task_batch_index++]);
+        // null check: 避免触发了非预期的事件，获取的回调函数是空的
+        if (task->m_cb) {
+            task->m_cb();
+        }
+        delete task;
+        if (deadline > 0 && getMonotonicUs() >= deadline) {
+            break;
+        }
+    }
+    if (m_task_batch_index == m_task_batch.size()) {
+        m_task_batch.clear();
+        m_task_batch_index = 0;
+        return;
+    }
+    // 超出预算，剩余的任务留到下一轮
+    m_tasks_deferred.store(m_tasks_deferred.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    if (m_task_batch_index >= m_task_batch.size() / 2) {
+        m_task_batch.erase(m_task_batch.begin(), m_task_batch.begin() + m_task_batch_index);
+        m_task_batch_index = 0;
+    }
+}
+
+bool EventLoop::hasPendingTasks() const {
+    return m_task_batch_index < m_task_batch.size() || !m_pending_tasks.empty();
+}
+
+// 回调函数执行期间可能关闭 fd 或取消监听，只分发仍在监听的事件
+void EventLoop::dispatchEvent(FdEvent *fd_event, TriggerEvent event_type) {
+    if (!fd_event->isListening(event_type)) {
+        return;
+    }
+    if (m_direct_dispatch) {
+        fd_event->handleEvent(event_type);
+    }
+    else {
+        // 回调函数只能移动，不再拷贝出来，执行时再从 FdEvent 中取出
+        // 执行前 fd 可能已经关闭并被复用，代数不一致时丢弃
+        uint32_t generation = fd_event->getGeneration();
+        addTask([fd_event, event_type, generation, this]() {
+            if (fd_event->getGeneration() != generation) {
+                m_stale_events.store(m_stale_events.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                return;
+            }
+            fd_event->handleEvent(event_type);
+        });
+    }
+}
+
+int EventLoop::busyPoll() {
+    int64_t deadline = getMonotonicUs() + m_busy_poll_us;
+    while (true) {
+        int rt = m_poller->poll(m_result_events.data(), static_cast<int>(m_result_events.size()), 0);
+        if (rt != 0) {
+            if (rt > 0) {
+                m_busy_poll_us = m_busy_poll_max_us; // 有事件，保持最大自旋时间
+            }
+            return rt;
+        }
+        if (!m_pending_tasks.empty() || m_stop_flag.load(std::memory_order_relaxed)) {
+            return 0;
+        }
+        if (getMonotonicUs() >= deadline) {
+            break;
+        }
+        cpuRelax();
+    }
+    // 自旋期间空闲，自旋时间减半，过小时直接阻塞
+    m_busy_poll_us /= 2;
+    if (m_busy_poll_us < g_busy_poll_min_us) {
+        m_busy_poll_us = 0;
     }
+    return 0;
+}
+
+void EventLoop::setBusyPoll(int64_t max_spin_us) {
+    m_busy_poll_max_us = max_spin_us > 0 ? max_spin_us : 0;
+    m_busy_poll_us = m_busy_poll_max_us;
+}
+
+int64_t EventLoop::getBusyPollUs() const {
+    return m_busy_poll_us;
+}
+
+void EventLoop::setTaskBudget(int max_tasks, int64_t max_us) {
+    m_task_budget_max = max_tasks > 0 ? max_tasks : 0;
+    m_task_budget_max_us = max_us > 0 ? max_us : 0;
 }
 
 // only write one byte to eventfd
 // call by other thread to wakeup this thread from epoll_wait
+// loop 没有阻塞(会在阻塞前检查任务队列)或者已经有未读取的唤醒时，不再写 eventfd
 void EventLoop::wakeup() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!m_sleeping.load(std::memory_order_relaxed)) {
+        return;
+    }
+    if (m_wakeup_pending.exchange(true, std::memory_order_acq_rel)) {
+        return;
+    }
+    m_wakeup_writes.fetch_add(1, std::memory_order_relaxed);
     m_wakeup_event->wakeup();
 }
 
@@ -176,7 +343,11 @@ void EventLoop::stop() {
     wakeup();
 }
 
-void EventLoop::handleWakeUp() {}
+// wakeup fd 可读时才读取 eventfd，读取后允许下一次唤醒
+void EventLoop::handleWakeUp() {
+    m_wakeup_event->handleEvent(TriggerEvent::IN_EVENT);
+    m_wakeup_pending.store(false, std::memory_order_release);
+}
 
 //* 添加一个监听的fd
 // 说明，对于主从 Reactor模型，主Reactor负责监听新连接，从Reactor负责处理已有连接
@@ -184,66 +355,142 @@ void EventLoop::handleWakeUp() {}
 // 通过回调函数形式添加到 这个 EventLoop 任务队列中，等到下次唤醒后 该 EventLoop 线程自己执行, 自己管理这个 fd
 void EventLoop::addEpollEvent(FdEvent *event) {
     if (isInLoopThread()) {
-        // auto it = m_listen_fds.find(event->getFd());
-        // int op = EPOLL_CTL_ADD;
-        // if (it != m_listen_fds.end()) { // 已经存在
-        //     op = EPOLL_CTL_MOD;
-        // }
-        // epoll_event ev = event->getEpollEvent(); // 获取事件
-        // int rt = epoll_ctl(m_epoll_fd, op, event->getFd(), &ev);
-        // if (rt < 0) {
-        //     ERRORLOG("Failed to add epoll event, error [%s]", strerror(errno));
-        // }
-        ADD_TO_EPOLL(event, m_epoll_fd);
+        updateEpollEvent(event);
     }
     else {
         // ! 不在当前 EventLoop 运行的线程，回调函数处理，添加到该 Loop 对象的任务队列
-        auto callback = [event, this]() {
-            ADD_TO_EPOLL(event, this->m_epoll_fd);
+        // 执行前 fd 可能已经关闭并被新连接复用，代数不一致时丢弃(新连接会自己添加)
+        uint32_t generation = event->getGeneration();
+        auto callback = [event, generation, this]() {
+            if (event->getGeneration() != generation) {
+                DEBUGLOG("drop stale add of fd[%d], generation [%u]", event->getFd(), generation);
+                return;
+            }
+            updateEpollEvent(event);
         };
-        addTask(callback, true); // 添加到任指定 EventLoop 任务队列
+        addTask(std::move(callback), true); // 添加到任指定 EventLoop 任务队列
     }
 }
 
 void EventLoop::deleteEpollEvent(FdEvent *event) {
     if (isInLoopThread()) {
-        // auto it = m_listen_fds.find(event->getFd());
-        // if (it != m_listen_fds.end()) {
-        //     int rt = epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, event->getFd(), nullptr);
-        //     if (rt < 0) {
-        //         ERRORLOG("Failed to delete epoll event, error [%s]", strerror(errno));
-        //     }
-        //     m_listen_fds.erase(it);
-        //     DEBUGLOG("Delete epoll event, fd [%d]", event->getFd());
-        // }
-        DELETE_FROM_EPOLL(event, m_epoll_fd);
+        removeEpollEvent(event);
     }
     else {
-        auto callback = [event, this]() {
-            DELETE_FROM_EPOLL(event, this->m_epoll_fd);
+        // 关闭后(代数已经改变)内核已经自动删除，不能再删除复用该 fd 的新连接
+        uint32_t generation = event->getGeneration();
+        auto callback = [event, generation, this]() {
+            if (event->getGeneration() != generation) {
+                DEBUGLOG("drop stale delete of fd[%d], generation [%u]", event->getFd(), generation);
+                return;
+            }
+            removeEpollEvent(event);
         };
-        addTask(callback, true);
+        addTask(std::move(callback), true);
     }
 }
 
-//* 添加任务到队列，注意：当前线程的 EventLoop 循环跳出后执行队列中的任务
-void EventLoop::addTask(std::function<void()> cb, bool is_wakeup) {
-    {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        m_pending_tasks.push(cb);
+// 例如 TcpConnection 每条消息都会调用 listenReadEvent/listenWriteEvent，监听事件没有变化时不再修改
+void EventLoop::updateEpollEvent(FdEvent *event) {
+    uint32_t events = event->getEpollEvent().events;
+    if (event->isRegistered() && event->getRegisteredEvents() == events) {
+        m_ctl_skipped.store(m_ctl_skipped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return;
+    }
+    m_ctl_calls.store(m_ctl_calls.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    if (m_poller->addEvent(event)) {
+        event->setRegistered(true, events);
+    }
+}
+
+// fd 已经关闭(FdEvent::close 清除了注册状态)时 Poller 中仍可能存在，交给 Poller 判断
+void EventLoop::removeEpollEvent(FdEvent *event) {
+    if (event->isRegistered()) {
+        m_ctl_calls.store(m_ctl_calls.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+    m_poller->deleteEvent(event);
+    event->setRegistered(false);
+}
+
+void EventLoop::setTimingWheel(int64_t tick_ms) {
+    if (isInLoopThread()) {
+        m_timer->setTimingWheel(tick_ms);
+    }
+    else {
+        auto callback = [tick_ms, this]() {
+            m_timer->setTimingWheel(tick_ms);
+        };
+        addTask(std::move(callback), true);
+    }
+}
+
+void EventLoop::setTimerSlack(int64_t slack_us) {
+    if (isInLoopThread()) {
+        m_timer->setSlack(slack_us);
     }
+    else {
+        auto callback = [slack_us, this]() {
+            m_timer->setSlack(slack_us);
+        };
+        addTask(std::move(callback), true);
+    }
+}
+
+bool EventLoop::isEdgeTriggeredSupported() const {
+    return m_poller->isEdgeTriggeredSupported();
+}
+
+EventLoopStats EventLoop::getStats() const {
+    EventLoopStats stats;
+    stats.m_ctl_calls = m_ctl_calls.load(std::memory_order_relaxed);
+    stats.m_ctl_skipped = m_ctl_skipped.load(std::memory_order_relaxed);
+    stats.m_wakeup_writes = m_wakeup_writes.load(std::memory_order_relaxed);
+    stats.m_tasks_deferred = m_tasks_deferred.load(std::memory_order_relaxed);
+    stats.m_stale_events = m_stale_events.load(std::memory_order_relaxed);
+    stats.m_connections = getConnectionCount();
+    stats.m_queued_bytes = getQueuedBytes();
+    stats.m_busy_permille = getBusyPermille();
+    stats.m_timer_settime = m_timer->getSettimeCalls();
+    stats.m_timer_settime_saved = m_timer->getSettimeSaved();
+    stats.m_poll_wait_us = m_poll_wait_hist.snapshot();
+    stats.m_handler_us = m_handler_hist.snapshot();
+    stats.m_ready_events = m_ready_events_hist.snapshot();
+    stats.m_queue_depth = m_queue_depth_hist.snapshot();
+    stats.m_timer_lag_us = m_timer->getLagHistogram().snapshot();
+    return stats;
+}
+
+//* 添加任务到队列，注意：当前线程的 EventLoop 循环跳出后执行队列中的任务
+void EventLoop::addTask(Task cb, bool is_wakeup) {
+    m_pending_tasks.push(new PendingTask(std::move(cb)));
     if (is_wakeup)
         wakeup();
 }
 
-//* 添加定时任务
+//* 添加定时任务, 定时器只在 EventLoop 线程中访问
 void EventLoop::addTimerEvent(TimerEvent::s_ptr event) {
-    m_timer->addTimerEvent(event);
+    if (isInLoopThread()) {
+        m_timer->addTimerEvent(event);
+    }
+    else {
+        auto callback = [event, this]() {
+            m_timer->addTimerEvent(event);
+        };
+        addTask(std::move(callback), true);
+    }
 }
 
 //* 移除定时任务
 void EventLoop::deleteTimerEvent(TimerEvent::s_ptr event) {
-    m_timer->deleteTimerEvent(event);
+    if (isInLoopThread()) {
+        m_timer->deleteTimerEvent(event);
+    }
+    else {
+        auto callback = [event, this]() {
+            m_timer->deleteTimerEvent(event);
+        };
+        addTask(std::move(callback), true);
+    }
 }
 
 bool EventLoop::isInLoopThread() {
@@ -261,4 +508,8 @@ bool EventLoop::isLooping() const {
     return m_is_looping;
 }
 
+void EventLoop::setDirectDispatch(bool value) {
+    m_direct_dispatch = value;
+}
+
 } // namespace rapidrpc
\ No newline at end of file
@@ -38,42 +38,54 @@ void FdEvent::setNonBlocking() {
     }
 }
 
-// * 应该只能被调用一次
-std::function<void()> FdEvent::getHandler(TriggerEvent event) {
-    if (event == TriggerEvent::IN_EVENT) {
-        // read callback
-        return m_read_callback;
+void FdEvent::handleEvent(TriggerEvent event) {
+    Task *slot = &m_read_callback;
+    if (event == TriggerEvent::OUT_EVENT) {
+        slot = &m_write_callback;
     }
-    else if (event == TriggerEvent::OUT_EVENT) {
-        // write callback
-        return m_write_callback;
+    else if (event == TriggerEvent::ERROR_EVENT) {
+        slot = &m_error_callback;
     }
-    else {
-        return nullptr;
+    if (!*slot) {
+        return;
+    }
+    // move 不会拷贝/分配内存, 移动后 slot 为空
+    Task cb(std::move(*slot));
+    cb();
+    // 回调中没有重新 listen，并且没有 clearEvent/close，恢复回调函数
+    if (!*slot && isListening(event)) {
+        *slot = std::move(cb);
     }
 }
-void FdEvent::listen(TriggerEvent event, std::function<void()> callback) {
+
+void FdEvent::listen(TriggerEvent event, Task callback) {
     if (event == TriggerEvent::IN_EVENT) {
         m_listen_events.events |= EPOLLIN;
         // m_read_callback = callback;
         m_read_callback = std::move(callback);
     }
+    else if (event == TriggerEvent::ERROR_EVENT) {
+        // EPOLLERR/EPOLLHUP 总是会被 epoll 返回，这里只作为标记
+        m_listen_events.events |= EPOLLERR;
+        m_error_callback = std::move(callback);
+    }
     else {
         m_listen_events.events |= EPOLLOUT;
         // m_write_callback = callback;
         m_write_callback = std::move(callback);
     }
-    //! 同时设置 data.ptr 为 this 指针，用于在 epoll_wait 时获取到对应的 FdEvent 对象
-    // 将 epoll_event{events,data} 与 本对象绑定
+    //! epoll data 由 getEpollEvent 设置为 this 指针和当前代数，用于在 epoll_wait 时获取到对应的 FdEvent 对象
     // 通常会设置 ev.data.fd = fd(这里用 FdEvent 包装类型), 都是为了在 epoll_wait 返回时知道是哪个fd触发了事件
-    m_listen_events.data.ptr = this; // set the pointer to this object
 }
 
+// ! 先清除监听事件和注册状态、增加代数再关闭 fd: 关闭后 fd 可能立即被其他线程 accept 复用(FdEventGroup 中是同一个对象)
 void FdEvent::close() {
+    memset(&m_listen_events, 0, sizeof(m_listen_events));
+    setRegistered(false);
+    m_generation.fetch_add(1, std::memory_order_release);
     if (m_fd > 0) {
         ::close(m_fd);
     }
-    memset(&m_listen_events, 0, sizeof(m_listen_events));
 }
 
 void FdEvent::clearEvent(TriggerEvent event) {
@@ -81,6 +93,10 @@ void FdEvent::clearEvent(TriggerEvent event) {
         m_listen_events.events &= ~EPOLLIN;
         m_read_callback = nullptr;
     }
+    else if (event == TriggerEvent::ERROR_EVENT) {
+        m_listen_events.events &= ~EPOLLERR;
+        m_error_callback = nullptr;
+    }
     else {
         m_listen_events.events &= ~EPOLLOUT;
         m_write_callback = nullptr;
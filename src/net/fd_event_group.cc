@@ -1,4 +1,5 @@
 #include "rapidrpc/net/fd_event_group.h"
+#include "rapidrpc/common/log.h"
 
 namespace rapidrpc {
 
@@ -9,42 +10,62 @@ FdEventGroup *FdEventGroup::GetGlobalFdEventGroup() {
         return g_fd_event_group;
     }
     // local static variable, thread safe
-    static FdEventGroup fd_event_group(128); // 1024个fd_event
+    static FdEventGroup fd_event_group;
     g_fd_event_group = &fd_event_group;
     return g_fd_event_group;
 }
 
-FdEventGroup::FdEventGroup(int size) : m_fd_event_group(size, nullptr) {
-
-    // fd 0~size-1
-    for (int i = 0; i < size; i++) {
-        m_fd_event_group[i] = new FdEvent(i);
-    }
-}
+FdEventGroup::FdEventGroup() {}
 
 FdEventGroup::~FdEventGroup() {
-    for (size_t i = 0; i < m_fd_event_group.size(); i++) {
-        if (m_fd_event_group[i]) {
-            delete m_fd_event_group[i];
-            m_fd_event_group[i] = nullptr;
+    for (int i = 0; i < MAX_SEGMENTS; i++) {
+        Segment *segment = m_segments[i].load(std::memory_order_acquire);
+        if (!segment) {
+            continue;
         }
+        for (int j = 0; j < SEGMENT_SIZE; j++) {
+            delete segment->m_events[j].load(std::memory_order_acquire);
+        }
+        delete segment;
+        m_segments[i].store(nullptr, std::memory_order_relaxed);
     }
 }
 
 FdEvent *FdEventGroup::getFdEvent(int fd) {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    if ((size_t)fd >= m_fd_event_group.size()) {
-        // resize
-        int old_size = m_fd_event_group.size();
-        int new_size = fd * 1.5;
-        m_fd_event_group.resize(new_size, nullptr);
-        for (int i = old_size; i < new_size; i++) {
-            m_fd_event_group[i] = new FdEvent(i);
+    if (fd < 0 || fd >= MAX_FD) {
+        ERRORLOG("getFdEvent error, invalid fd[%d], max fd[%d]", fd, MAX_FD);
+        return nullptr;
+    }
+
+    std::atomic<Segment *> &segment_slot = m_segments[fd >> SEGMENT_BITS];
+    Segment *segment = segment_slot.load(std::memory_order_acquire);
+    if (!segment) {
+        Segment *new_segment = new Segment();
+        if (segment_slot.compare_exchange_strong(segment, new_segment, std::memory_order_acq_rel,
+                                                 std::memory_order_acquire)) {
+            segment = new_segment;
+        }
+        else {
+            // 其他线程已经发布，segment 为其发布的段
+            delete new_segment;
+        }
+    }
+
+    std::atomic<FdEvent *> &event_slot = segment->m_events[fd & (SEGMENT_SIZE - 1)];
+    FdEvent *event = event_slot.load(std::memory_order_acquire);
+    if (!event) {
+        FdEvent *new_event = new FdEvent(fd);
+        if (event_slot.compare_exchange_strong(event, new_event, std::memory_order_acq_rel,
+                                               std::memory_order_acquire)) {
+            event = new_event;
+            m_allocated.fetch_add(1, std::memory_order_relaxed);
+        }
+        else {
+            delete new_event;
         }
     }
-    // 如果是 new fd/ 或者释放后重新获取的(FdEvent.close)，都使用 memset fd_event
-    // m_fd_event_group[fd]->m_fd = fd;
-    return m_fd_event_group[fd];
+    // 如果是 new fd/ 或者释放后重新获取的(FdEvent.close 已经重置监听事件)，都复用同一个 FdEvent
+    return event;
 }
 
-} // namespace rapidrpc
\ No newline at end of file
+} // namespace rapidrpc
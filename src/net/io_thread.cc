@@ -2,6 +2,10 @@
 #include "rapidrpc/net/io_thread.h"
 #include "rapidrpc/common/log.h"
 #include "rapidrpc/common/util.h"
+#include "rapidrpc/common/config.h"
+
+#include <string.h>
+#include <errno.h>
 
 namespace rapidrpc {
 
@@ -9,7 +13,7 @@ namespace rapidrpc {
  * @brief 子线程对象，并启动一个 EventLoop
  * @note 注意生命周期，如果析构，会停止 EventLoop，并等待线程结束
  */
-IOThread::IOThread() {
+IOThread::IOThread(int index) : m_index(index) {
     int rt = sem_init(&m_init_semaphore, 0, 0); // 初始化信号量
     if (rt != 0) {
         ERRORLOG("Failed to init m_init_semaphore");
@@ -52,9 +56,31 @@ void *IOThread::Main(void *arg) {
     // 线程入口函数
     IOThread *thread = static_cast<IOThread *>(arg);
 
+    // 先绑定 CPU, EventLoop 和之后在本线程首次访问的内存位于本地 NUMA 节点
+    std::vector<int> cpus;
+    if (Config::GetGlobalConfig() && !Config::GetGlobalConfig()->m_io_thread_cpus.empty()) {
+        std::vector<int> all = parseCpuList(Config::GetGlobalConfig()->m_io_thread_cpus);
+        if (all.empty()) {
+            ERRORLOG("Invalid io_thread_cpus [%s]", Config::GetGlobalConfig()->m_io_thread_cpus.c_str());
+        }
+        else {
+            cpus.push_back(all[thread->m_index % all.size()]);
+        }
+    }
+    std::string name = "rapidrpc-io-" + std::to_string(thread->m_index);
+    setThreadName(name);
+    BindCurrentThread(name, cpus);
+
     // 创建一个 EventLoop 对象
     thread->m_event_loop = new EventLoop();
     thread->m_tid = getThreadId(); // 在线程内完成赋值
+    if (Config::GetGlobalConfig() && Config::GetGlobalConfig()->m_busy_poll_us > 0) {
+        thread->m_event_loop->setBusyPoll(Config::GetGlobalConfig()->m_busy_poll_us);
+    }
+    if (Config::GetGlobalConfig()) {
+        thread->m_event_loop->setTaskBudget(Config::GetGlobalConfig()->m_loop_max_tasks,
+                                            Config::GetGlobalConfig()->m_loop_max_task_us);
+    }
 
     // ! 唤醒主线程
     sem_post(&thread->m_init_semaphore);
@@ -68,6 +94,21 @@ void *IOThread::Main(void *arg) {
     return nullptr;
 }
 
+void IOThread::BindCurrentThread(const std::string &name, const std::vector<int> &cpus) {
+    if (cpus.empty()) {
+        return;
+    }
+    if (!setThreadAffinity(cpus)) {
+        ERRORLOG("Failed to bind thread [%s] to cpus, error [%s]", name.c_str(), strerror(errno));
+        return;
+    }
+    // 没有 NUMA 支持的内核返回 ENOSYS, 不影响绑定
+    if (!setLocalMemoryPolicy() && errno != ENOSYS) {
+        ERRORLOG("Failed to set local memory policy for thread [%s], error [%s]", name.c_str(), strerror(errno));
+    }
+    INFOLOG("Thread [%s] bound to %lu cpus, first cpu [%d]", name.c_str(), cpus.size(), cpus[0]);
+}
+
 EventLoop *IOThread::getEventLoop() {
     return m_event_loop;
 }
@@ -1,37 +1,245 @@
 #include "rapidrpc/common/log.h"
+#include "rapidrpc/common/config.h"
+#include "rapidrpc/common/util.h"
 #include "rapidrpc/net/io_thread_group.h"
 
+#include <algorithm>
+
 namespace rapidrpc {
 
 IOThreadGroup::IOThreadGroup(int size) : m_size(size) {
     m_io_thread_group.reserve(m_size);
     for (int i = 0; i < m_size; i++) {
-        m_io_thread_group.push_back(new IOThread());
+        m_io_thread_group.push_back(new IOThread(m_next_index++));
     }
+    m_placement = IOThreadPlacement::Create(Config::GetGlobalConfig() ? Config::GetGlobalConfig()->m_io_thread_placement
+                                                                      : "round_robin");
 }
 
 IOThreadGroup::~IOThreadGroup() {
+    if (!m_started) {
+        // 没有启动的线程阻塞在启动信号量上, 启动后才能停止并等待结束
+        start();
+    }
     for (auto &thread : m_io_thread_group) {
         delete thread;
     }
+    for (auto &draining : m_draining) {
+        delete draining.m_thread;
+    }
+    delete m_placement;
 }
 
 void IOThreadGroup::start() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_started = true;
     for (auto &thread : m_io_thread_group) {
         thread->start();
     }
+    for (auto &draining : m_draining) {
+        draining.m_thread->start();
+    }
 }
 
 void IOThreadGroup::join() {
-    for (auto &thread : m_io_thread_group) {
+    std::vector<IOThread *> threads;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        threads = m_io_thread_group;
+        for (auto &draining : m_draining) {
+            threads.push_back(draining.m_thread);
+        }
+    }
+    for (auto &thread : threads) {
         thread->join();
     }
 }
 
 IOThread *IOThreadGroup::getIOThread() {
-    int ret = m_index;
-    m_index = (m_index + 1) % m_size;
-    return m_io_thread_group[ret];
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_io_thread_group[m_placement->select(m_io_thread_group)];
+}
+
+IOThread *IOThreadGroup::getIOThread(int index) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_io_thread_group[index];
+}
+
+int IOThreadGroup::getSize() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_size;
+}
+
+int IOThreadGroup::getDrainingCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return static_cast<int>(m_draining.size());
+}
+
+IOThread *IOThreadGroup::addIOThread() {
+    int index = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_draining.empty()) {
+            // 恢复最近开始排空的线程, 它剩余的连接最多
+            IOThread *thread = m_draining.back().m_thread;
+            m_draining.pop_back();
+            m_io_thread_group.push_back(thread);
+            m_size = static_cast<int>(m_io_thread_group.size());
+            INFOLOG("IOThreadGroup resume draining io thread, loop [%p]", thread->getEventLoop());
+            return thread;
+        }
+        index = m_next_index++;
+    }
+
+    // 创建时等待新线程的 EventLoop 初始化完成, 不持有锁，不阻塞选择 IO 线程
+    IOThread *thread = new IOThread(index);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_started) {
+        thread->start();
+    }
+    m_io_thread_group.push_back(thread);
+    m_size = static_cast<int>(m_io_thread_group.size());
+    INFOLOG("IOThreadGroup add io thread, index [%d]", index);
+    return thread;
+}
+
+IOThread *IOThreadGroup::drainIOThread(IOThread *thread) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return drainIOThreadLocked(thread);
+}
+
+IOThread *IOThreadGroup::drainIOThreadLocked(IOThread *thread) {
+    if (m_io_thread_group.size() <= 1) {
+        return nullptr;
+    }
+    auto it = m_io_thread_group.end();
+    if (thread) {
+        it = std::find(m_io_thread_group.begin(), m_io_thread_group.end(), thread);
+    }
+    else {
+        // 连接数最少的线程, 相同时选择最后创建的
+        it = m_io_thread_group.begin();
+        for (auto cur = m_io_thread_group.begin(); cur != m_io_thread_group.end(); ++cur) {
+            if ((*cur)->getEventLoop()->getConnectionCount() <= (*it)->getEventLoop()->getConnectionCount()) {
+                it = cur;
+            }
+        }
+    }
+    if (it == m_io_thread_group.end()) {
+        return nullptr;
+    }
+    thread = *it;
+    m_io_thread_group.erase(it);
+    m_size = static_cast<int>(m_io_thread_group.size());
+
+    DrainingThread draining;
+    draining.m_thread = thread;
+    draining.m_start_ms = getMonotonicUs() / 1000;
+    m_draining.push_back(draining);
+    INFOLOG("IOThreadGroup drain io thread, loop [%p], connections [%ld]", thread->getEventLoop(),
+            thread->getEventLoop()->getConnectionCount());
+    return thread;
+}
+
+int IOThreadGroup::reapDrained() {
+    std::vector<IOThread *> reaped;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto it = m_draining.begin(); it != m_draining.end();) {
+            EventLoop *event_loop = it->m_thread->getEventLoop();
+            if (event_loop->getConnectionCount() == 0 && event_loop->getPendingReplies() == 0) {
+                reaped.push_back(it->m_thread);
+                it = m_draining.erase(it);
+            }
+            else {
+                ++it;
+            }
+        }
+        if (!m_started) {
+            // 同析构函数, 没有启动的线程需要先启动
+            for (auto &thread : reaped) {
+                thread->start();
+            }
+        }
+    }
+    // 停止 EventLoop 并等待线程结束
+    for (auto &thread : reaped) {
+        INFOLOG("IOThreadGroup io thread drained, loop [%p]", thread->getEventLoop());
+        delete thread;
+    }
+    return static_cast<int>(reaped.size());
+}
+
+std::vector<IOThread *> IOThreadGroup::getDrainExpired(int64_t timeout_ms) {
+    std::vector<IOThread *> expired;
+    int64_t now_ms = getMonotonicUs() / 1000;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto &draining : m_draining) {
+        if (!draining.m_expired && now_ms - draining.m_start_ms >= timeout_ms) {
+            draining.m_expired = true;
+            expired.push_back(draining.m_thread);
+        }
+    }
+    return expired;
+}
+
+int IOThreadGroup::autoscale(const IOThreadAutoscale &policy) {
+    int size = 0;
+    int64_t busy = 0;
+    bool draining = false;
+    std::vector<EventLoop *> loops;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        size = m_size;
+        draining = !m_draining.empty();
+        for (auto &thread : m_io_thread_group) {
+            busy += thread->getEventLoop()->getBusyPermille();
+            loops.push_back(thread->getEventLoop());
+        }
+    }
+    // 繁忙比例在每轮循环结束时更新, 唤醒一次，阻塞等待的空闲线程下次读取时也是最新的
+    // 释放锁之后再唤醒: 线程要先排空再由 reapDrained 释放, TcpServer 在主线程中调用 autoscale 和 reapDrained
+    for (auto &loop : loops) {
+        loop->addTask([]() {}, true);
+    }
+    int64_t avg = size > 0 ? busy / size : 0;
+
+    int max_threads = std::max(policy.m_min_threads, policy.m_max_threads);
+    if (size < policy.m_min_threads || (avg > policy.m_high_permille && size < max_threads)) {
+        addIOThread();
+        INFOLOG("IOThreadGroup autoscale up, avg busy [%ld permille], threads [%d]", avg, size + 1);
+        return 1;
+    }
+    // 排空后剩余线程的平均繁忙比例约为 avg * size / (size - 1), 仍需低于 m_high_permille, 避免反复增减
+    if (!draining && size > 1
+        && (size > max_threads
+            || (avg < policy.m_low_permille && size > policy.m_min_threads
+                && avg * size < static_cast<int64_t>(policy.m_high_permille) * (size - 1)))) {
+        if (drainIOThread()) {
+            INFOLOG("IOThreadGroup autoscale down, avg busy [%ld permille], threads [%d]", avg, size - 1);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+void IOThreadGroup::setPlacement(IOThreadPlacement *placement) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!placement || placement == m_placement) {
+        return;
+    }
+    delete m_placement;
+    m_placement = placement;
+}
+
+std::vector<EventLoopStats> IOThreadGroup::getStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<EventLoopStats> stats;
+    stats.reserve(m_io_thread_group.size());
+    for (auto &thread : m_io_thread_group) {
+        stats.push_back(thread->getEventLoop()->getStats());
+    }
+    return stats;
 }
 
-} // namespace rapidrpc
\ No newline at end of file
+} // namespace rapidrpc
@@ -0,0 +1,129 @@
+#include "rapidrpc/net/io_thread_placement.h"
+#include "rapidrpc/common/log.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <functional>
+
+namespace rapidrpc {
+
+class RoundRobinPlacement: public IOThreadPlacement {
+public:
+    size_t select(const std::vector<IOThread *> &threads) override {
+        return m_next.fetch_add(1, std::memory_order_relaxed) % threads.size();
+    }
+
+    const char *getName() const override {
+        return "round_robin";
+    }
+
+private:
+    std::atomic<uint32_t> m_next{0};
+};
+
+/**
+ * @brief 选择负载最小的线程, Load 为 (EventLoop *) -> 可比较的负载
+ * 每次从不同的线程开始扫描，负载相同时轮流选择，避免总是选择第一个线程
+ */
+template <typename Load>
+class LeastLoadPlacement: public IOThreadPlacement {
+public:
+    LeastLoadPlacement(const char *name, Load load) : m_name(name), m_load(load) {}
+
+    size_t select(const std::vector<IOThread *> &threads) override {
+        size_t size = threads.size();
+        size_t start = m_next.fetch_add(1, std::memory_order_relaxed) % size;
+        size_t best = start;
+        auto best_load = m_load(threads[start]->getEventLoop());
+        for (size_t i = 1; i < size; i++) {
+            size_t index = (start + i) % size;
+            auto load = m_load(threads[index]->getEventLoop());
+            if (load < best_load) {
+                best = index;
+                best_load = load;
+            }
+        }
+        return best;
+    }
+
+    const char *getName() const override {
+        return m_name;
+    }
+
+private:
+    const char *m_name;
+    Load m_load;
+    std::atomic<uint32_t> m_next{0};
+};
+
+template <typename Load>
+static IOThreadPlacement *MakeLeastLoad(const char *name, Load load) {
+    return new LeastLoadPlacement<Load>(name, load);
+}
+
+/**
+ * @brief power of two choices: 随机选择两个不同的线程，取繁忙比例较低的一个(相同时连接数较少)
+ * 不需要扫描所有线程，并且避免所有新连接同时涌向同一个(统计有延迟的)最空闲线程
+ */
+class PowerOfTwoBusyPlacement: public IOThreadPlacement {
+public:
+    size_t select(const std::vector<IOThread *> &threads) override {
+        size_t size = threads.size();
+        if (size == 1) {
+            return 0;
+        }
+        size_t a = nextRandom() % size;
+        size_t b = nextRandom() % (size - 1);
+        if (b >= a) {
+            b++;
+        }
+        EventLoop *loop_a = threads[a]->getEventLoop();
+        EventLoop *loop_b = threads[b]->getEventLoop();
+        int busy_a = loop_a->getBusyPermille();
+        int busy_b = loop_b->getBusyPermille();
+        if (busy_a != busy_b) {
+            return busy_a < busy_b ? a : b;
+        }
+        return loop_a->getConnectionCount() <= loop_b->getConnectionCount() ? a : b;
+    }
+
+    const char *getName() const override {
+        return "p2c_busy";
+    }
+
+private:
+    // xorshift64, 每个线程独立的状态，不加锁
+    static uint64_t nextRandom() {
+        static thread_local uint64_t state = 0;
+        if (state == 0) {
+            state = std::chrono::steady_clock::now().time_since_epoch().count();
+            state ^= std::hash<std::thread::id>()(std::this_thread::get_id());
+            state |= 1;
+        }
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+};
+
+IOThreadPlacement *IOThreadPlacement::Create(const std::string &type) {
+    if (type == "least_connections") {
+        return MakeLeastLoad("least_connections", [](EventLoop *loop) { return loop->getConnectionCount(); });
+    }
+    if (type == "least_queued_bytes") {
+        return MakeLeastLoad("least_queued_bytes", [](EventLoop *loop) {
+            return std::make_pair(loop->getQueuedBytes(), loop->getConnectionCount());
+        });
+    }
+    if (type == "p2c_busy") {
+        return new PowerOfTwoBusyPlacement();
+    }
+    if (type != "round_robin") {
+        ERRORLOG("Unknown io thread placement [%s], use round_robin", type.c_str());
+    }
+    return new RoundRobinPlacement();
+}
+
+} // namespace rapidrpc
@@ -0,0 +1,262 @@
+#include "rapidrpc/net/io_uring_poller.h"
+#include "rapidrpc/common/log.h"
+
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <string.h>
+#include <time.h>
+
+namespace rapidrpc {
+
+static const uint64_t g_remove_user_data = ~0ULL; // POLL_REMOVE 请求自身的 user_data
+
+static int sysIoUringSetup(unsigned entries, io_uring_params *params) {
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+static int sysIoUringEnter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags, const void *arg,
+                           size_t argsz) {
+    return static_cast<int>(syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, arg, argsz));
+}
+
+IoUringPoller::IoUringPoller() {}
+
+IoUringPoller::~IoUringPoller() {
+    if (m_sqes) {
+        munmap(m_sqes, m_sqes_size);
+    }
+    if (m_ring_ptr) {
+        munmap(m_ring_ptr, m_ring_size);
+    }
+    if (m_ring_fd >= 0) {
+        close(m_ring_fd);
+    }
+}
+
+bool IoUringPoller::init(unsigned entries) {
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    m_ring_fd = sysIoUringSetup(entries, &params);
+    if (m_ring_fd < 0) {
+        ERRORLOG("io_uring_setup failed, error [%s]", strerror(errno));
+        return false;
+    }
+    if (!(params.features & IORING_FEAT_SINGLE_MMAP) || !(params.features & IORING_FEAT_EXT_ARG)) {
+        ERRORLOG("io_uring features not supported, features [%u]", params.features);
+        return false;
+    }
+
+    size_t sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    size_t cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    m_ring_size = sq_size > cq_size ? sq_size : cq_size;
+    void *ptr = mmap(nullptr, m_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ring_fd,
+                     IORING_OFF_SQ_RING);
+    if (ptr == MAP_FAILED) {
+        ERRORLOG("mmap io_uring ring failed, error [%s]", strerror(errno));
+        return false;
+    }
+    m_ring_ptr = ptr;
+
+    m_sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+    ptr = mmap(nullptr, m_sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ring_fd, IORING_OFF_SQES);
+    if (ptr == MAP_FAILED) {
+        ERRORLOG("mmap io_uring sqes failed, error [%s]", strerror(errno));
+        return false;
+    }
+    m_sqes = static_cast<io_uring_sqe *>(ptr);
+
+    char *ring = static_cast<char *>(m_ring_ptr);
+    m_sq_head = reinterpret_cast<unsigned *>(ring + params.sq_off.head);
+    m_sq_tail = reinterpret_cast<unsigned *>(ring + params.sq_off.tail);
+    m_sq_array = reinterpret_cast<unsigned *>(ring + params.sq_off.array);
+    m_sq_mask = *reinterpret_cast<unsigned *>(ring + params.sq_off.ring_mask);
+    m_sq_entries = params.sq_entries;
+    m_sq_local_tail = m_sq_submitted = *m_sq_tail;
+
+    m_cq_head = reinterpret_cast<unsigned *>(ring + params.cq_off.head);
+    m_cq_tail = reinterpret_cast<unsigned *>(ring + params.cq_off.tail);
+    m_cq_mask = *reinterpret_cast<unsigned *>(ring + params.cq_off.ring_mask);
+    m_cqes = reinterpret_cast<io_uring_cqe *>(ring + params.cq_off.cqes);
+
+    DEBUGLOG("io_uring created, ring fd [%d], sq entries [%u], cq entries [%u]", m_ring_fd, params.sq_entries,
+             params.cq_entries);
+    return true;
+}
+
+io_uring_sqe *IoUringPoller::getSqe() {
+    unsigned head = __atomic_load_n(m_sq_head, __ATOMIC_ACQUIRE);
+    if (m_sq_local_tail - head >= m_sq_entries) {
+        // SQ 已满，先提交已有的请求
+        submit(0, 0);
+        head = __atomic_load_n(m_sq_head, __ATOMIC_ACQUIRE);
+        if (m_sq_local_tail - head >= m_sq_entries) {
+            return nullptr;
+        }
+    }
+    unsigned index = m_sq_local_tail & m_sq_mask;
+    io_uring_sqe *sqe = &m_sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    m_sq_array[index] = index;
+    m_sq_local_tail++;
+    return sqe;
+}
+
+int IoUringPoller::submit(unsigned min_complete, int timeout_ms) {
+    unsigned to_submit = m_sq_local_tail - m_sq_submitted;
+    if (to_submit == 0 && min_complete == 0) {
+        return 0;
+    }
+    __atomic_store_n(m_sq_tail, m_sq_local_tail, __ATOMIC_RELEASE);
+
+    int rt = 0;
+    if (min_complete == 0) {
+        rt = sysIoUringEnter(m_ring_fd, to_submit, 0, 0, nullptr, 0);
+    }
+    else {
+        __kernel_timespec ts;
+        io_uring_getevents_arg arg;
+        memset(&arg, 0, sizeof(arg));
+        if (timeout_ms >= 0) {
+            ts.tv_sec = timeout_ms / 1000;
+            ts.tv_nsec = (timeout_ms % 1000) * 1000000LL;
+            arg.ts = reinterpret_cast<uint64_t>(&ts);
+        }
+        rt = sysIoUringEnter(m_ring_fd, to_submit, min_complete, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg,
+                             sizeof(arg));
+    }
+    // 返回已提交的 SQE 数量；没有提交任何 SQE 时返回等待的错误(ETIME 超时, EINTR)
+    if (rt > 0) {
+        m_sq_submitted += static_cast<unsigned>(rt);
+    }
+    return rt;
+}
+
+void IoUringPoller::armPoll(int fd, Registration &reg) {
+    io_uring_sqe *sqe = getSqe();
+    if (!sqe) {
+        ERRORLOG("io_uring sq is full, failed to poll fd[%d]", fd);
+        return;
+    }
+    reg.m_gen++;
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = fd;
+    sqe->poll32_events = reg.m_events;
+    sqe->user_data = (static_cast<uint64_t>(fd) << 32) | reg.m_gen;
+    reg.m_armed = true;
+}
+
+void IoUringPoller::cancelPoll(int fd, Registration &reg) {
+    if (!reg.m_armed) {
+        return;
+    }
+    io_uring_sqe *sqe = getSqe();
+    if (!sqe) {
+        ERRORLOG("io_uring sq is full, failed to cancel poll of fd[%d]", fd);
+        return;
+    }
+    sqe->opcode = IORING_OP_POLL_REMOVE;
+    sqe->fd = -1;
+    sqe->addr = (static_cast<uint64_t>(fd) << 32) | reg.m_gen;
+    sqe->user_data = g_remove_user_data;
+    reg.m_armed = false;
+}
+
+bool IoUringPoller::addEvent(FdEvent *event) {
+    int fd = event->getFd();
+    if (fd < 0) {
+        return false;
+    }
+    if (static_cast<size_t>(fd) >= m_registrations.size()) {
+        size_t size = static_cast<size_t>(fd) + 1;
+        m_registrations.resize(size > 2 * m_registrations.size() ? size : 2 * m_registrations.size());
+    }
+    Registration &reg = m_registrations[fd];
+    epoll_event ev = event->getEpollEvent();
+    uint32_t events = ev.events;
+    // 监听事件没有变化的修改由 EventLoop 跳过(FdEvent::getRegisteredEvents)
+    // 这里重新提交 poll, 也用于 fd 关闭后被复用的情况
+    cancelPoll(fd, reg);
+    reg.m_event = event;
+    reg.m_data = ev.data.u64;
+    reg.m_events = events;
+    if (reg.m_events) {
+        armPoll(fd, reg);
+    }
+    DEBUGLOG("Add fd_event[fd=%d] to io_uring, events [%u]", fd, events);
+    return true;
+}
+
+void IoUringPoller::deleteEvent(FdEvent *event) {
+    int fd = event->getFd();
+    if (fd < 0 || static_cast<size_t>(fd) >= m_registrations.size() || !m_registrations[fd].m_event) {
+        return;
+    }
+    Registration &reg = m_registrations[fd];
+    cancelPoll(fd, reg);
+    reg.m_event = nullptr;
+    reg.m_events = 0;
+    // 立即提交，fd 随后可能被关闭，poll 请求会持有文件的引用
+    submit(0, 0);
+    DEBUGLOG("Delete io_uring event, fd [%d]", fd);
+}
+
+int IoUringPoller::poll(epoll_event *events, int max_events, int timeout_ms) {
+    // 重新提交上一轮已经完成的 poll(单次 poll，与 epoll LT 语义一致)
+    for (int fd : m_rearm_fds) {
+        Registration &reg = m_registrations[fd];
+        if (reg.m_event && !reg.m_armed && reg.m_events) {
+            armPoll(fd, reg);
+        }
+    }
+    m_rearm_fds.clear();
+
+    // 已经有完成事件时不阻塞
+    unsigned head = *m_cq_head;
+    unsigned tail = __atomic_load_n(m_cq_tail, __ATOMIC_ACQUIRE);
+    int rt = 0;
+    if (head != tail || timeout_ms == 0) {
+        rt = submit(0, 0);
+    }
+    else {
+        rt = submit(1, timeout_ms);
+    }
+    if (rt < 0 && errno != ETIME && errno != EBUSY) {
+        return -1;
+    }
+
+    int count = 0;
+    head = *m_cq_head;
+    tail = __atomic_load_n(m_cq_tail, __ATOMIC_ACQUIRE);
+    while (head != tail && count < max_events) {
+        io_uring_cqe *cqe = &m_cqes[head & m_cq_mask];
+        head++;
+        if (cqe->user_data == g_remove_user_data) {
+            continue;
+        }
+        int fd = static_cast<int>(cqe->user_data >> 32);
+        uint32_t gen = static_cast<uint32_t>(cqe->user_data);
+        if (static_cast<size_t>(fd) >= m_registrations.size()) {
+            continue;
+        }
+        Registration &reg = m_registrations[fd];
+        // 已经删除或者被新的 poll 替换
+        if (!reg.m_event || reg.m_gen != gen) {
+            continue;
+        }
+        reg.m_armed = false;
+        if (cqe->res < 0) {
+            ERRORLOG("io_uring poll fd[%d] failed, error [%s]", fd, strerror(-cqe->res));
+            reg.m_events = 0; // 不再重新提交，直到下一次 addEvent
+            continue;
+        }
+        events[count].events = static_cast<uint32_t>(cqe->res);
+        events[count].data.u64 = reg.m_data;
+        count++;
+        m_rearm_fds.push_back(fd);
+    }
+    __atomic_store_n(m_cq_head, head, __ATOMIC_RELEASE);
+    return count;
+}
+
+} // namespace rapidrpc
@@ -0,0 +1,23 @@
+#include "rapidrpc/net/poller.h"
+#include "rapidrpc/net/epoll_poller.h"
+#include "rapidrpc/net/io_uring_poller.h"
+#include "rapidrpc/common/log.h"
+
+namespace rapidrpc {
+
+Poller *Poller::Create(const std::string &type) {
+    if (type == "io_uring") {
+        IoUringPoller *poller = new IoUringPoller();
+        if (poller->init()) {
+            return poller;
+        }
+        ERRORLOG("io_uring is not available, fallback to epoll");
+        delete poller;
+    }
+    else if (type != "epoll") {
+        ERRORLOG("Unknown poller type [%s], use epoll", type.c_str());
+    }
+    return new EpollPoller();
+}
+
+} // namespace rapidrpc
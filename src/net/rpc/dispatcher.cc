@@ -110,6 +110,56 @@ void Dispatcher::dispatch(AbstractProtocol::s_ptr request, AbstractProtocol::s_p
     delete func_resp;
 }
 
+void Dispatcher::initWorkerPool(int threads, int queue_size, const std::string &scheduler) {
+    if (threads <= 0 || m_worker_pool) {
+        return;
+    }
+    m_worker_pool.reset(Executor::Create(scheduler, threads, queue_size));
+    INFOLOG("Dispatcher worker pool started, scheduler [%s], threads [%d], queue size [%d]",
+            m_worker_pool->getName(), threads, queue_size);
+}
+
+void Dispatcher::setServicePooled(const std::string &service_name, bool pooled) {
+    if (service_name == "*") {
+        m_pool_all_services = pooled;
+        return;
+    }
+    if (pooled) {
+        m_pooled_services.insert(service_name);
+    }
+    else {
+        m_pooled_services.erase(service_name);
+    }
+}
+
+bool Dispatcher::isPooled(AbstractProtocol::s_ptr request) {
+    if (!m_worker_pool) {
+        return false;
+    }
+    if (m_pool_all_services) {
+        return true;
+    }
+    if (m_pooled_services.empty()) {
+        return false;
+    }
+    TinyPBProtocol::s_ptr req = std::dynamic_pointer_cast<TinyPBProtocol>(request);
+    std::string service_name, method_name;
+    if (!req || !parseServiceAndMethod(req->m_method_name, service_name, method_name)) {
+        // 解析失败由 dispatch 返回错误
+        return false;
+    }
+    return m_pooled_services.count(service_name) > 0;
+}
+
+void Dispatcher::reject(AbstractProtocol::s_ptr request, AbstractProtocol::s_ptr response, Error err,
+                        const std::string &err_info) {
+    TinyPBProtocol::s_ptr req = std::dynamic_pointer_cast<TinyPBProtocol>(request);
+    TinyPBProtocol::s_ptr resp = std::dynamic_pointer_cast<TinyPBProtocol>(response);
+    ERRORLOG("Dispatcher::reject: msg_id=[%s], method [%s], %s", req->m_msg_id.c_str(), req->m_method_name.c_str(),
+             err_info.c_str());
+    resp->setMsgId(req->m_msg_id).setMethodName(req->m_method_name).setErrCodeAndInfo(err, err_info).complete();
+}
+
 bool Dispatcher::parseServiceAndMethod(const std::string &full_name, std::string &service_name,
                                        std::string &method_name) {
     auto pos = full_name.find_first_of('.');
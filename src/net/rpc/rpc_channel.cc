@@ -70,15 +70,16 @@ void RpcChannel::CallMethod(const google::protobuf::MethodDescriptor *method,
 
     // set timeout task
     // !! req, channel will not be released until timeout task is executed
-    // 如果没有超时，在取消定时任务时务必释放 req, channel，将定时任务回调函数清空/或者直接调用 deleteTimerEvent
-    m_timer_event = std::make_shared<TimerEvent>(rpc_controller->GetTimeout(), false, [req, channel]() {
+    // 如果没有超时，取消定时任务时调用 deleteTimerEvent，立即释放 req, channel
+    std::chrono::microseconds timeout(rpc_controller->GetTimeoutUs());
+    m_timer_event = std::make_shared<TimerEvent>(timeout, false, [req, channel]() {
         // timeout task
         auto controller = std::dynamic_pointer_cast<RpcController>(channel->m_controller);
         controller->StartCancel(); // canceled
         controller->SetError(Error::SYS_RPC_CALL_TIMEOUT,
                              "rpc call timeout, msg_id=[" + req->m_msg_id + "], " + "method_name=[" + req->m_method_name
                                  + "] " + "peer_addr=[" + channel->m_peer_addr->toString() + "], " + "timeout=["
-                                 + std::to_string(controller->GetTimeout()) + "ms]");
+                                 + std::to_string(controller->GetTimeoutUs()) + "us]");
         if (channel->m_done)
             channel->m_done->Run();
         channel->m_client->close();
@@ -94,6 +95,7 @@ void RpcChannel::CallMethod(const google::protobuf::MethodDescriptor *method,
             ERRORLOG("RpcChannel connect failed, error_code=%d, error_info=[%s], peer_addr=[%s]",
                      channel->m_client->getConnectErrorCode(), channel->m_client->getConnectErrorInfo().c_str(),
                      channel->m_peer_addr->toString().c_str());
+            channel->m_client->deleteTimerEvent(channel->m_timer_event); // 已经失败，不再执行超时任务
             if (channel->m_done)
                 channel->m_done->Run();
             channel->m_client->close();
@@ -108,10 +110,8 @@ void RpcChannel::CallMethod(const google::protobuf::MethodDescriptor *method,
                 if (channel->m_controller->IsCanceled()) {
                     return;
                 }
-                // 成功读取到 msg 数据包后，取消超时任务
-                // channel->m_client->deleteTimerEvent(channel->m_timer_event); // better
-                channel->m_timer_event->setCanceled(
-                    true); // cancel timeout task, and delete from timer queue until next timeout/onTimer
+                // 成功读取到 msg 数据包后，取消超时任务: 立即从定时器中删除，释放捕获的 req, channel
+                channel->m_client->deleteTimerEvent(channel->m_timer_event);
 
                 // after read response tiny pb protocol
                 TinyPBProtocol::s_ptr resp = std::dynamic_pointer_cast<TinyPBProtocol>(msg);
@@ -13,7 +13,7 @@ void RpcController::Reset() {
     m_local_addr.reset();
     m_peer_addr.reset();
 
-    m_timeout = 1000;
+    m_timeout_us = 1000000;
 }
 
 bool RpcController::Failed() const {
@@ -79,9 +79,15 @@ NetAddr::s_ptr RpcController::GetPeerAddr() const {
 }
 
 void RpcController::SetTimeout(int timeout) {
-    m_timeout = timeout;
+    m_timeout_us = static_cast<int64_t>(timeout) * 1000;
+}
+void RpcController::SetTimeout(std::chrono::microseconds timeout) {
+    m_timeout_us = timeout.count();
 }
 int RpcController::GetTimeout() const {
-    return m_timeout;
+    return static_cast<int>(m_timeout_us / 1000);
+}
+int64_t RpcController::GetTimeoutUs() const {
+    return m_timeout_us;
 }
 } // namespace rapidrpc
\ No newline at end of file
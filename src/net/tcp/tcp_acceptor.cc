@@ -2,10 +2,14 @@
 #include "rapidrpc/common/log.h"
 
 #include <fcntl.h>
+#include <unistd.h>
+#include <linux/filter.h>
+#include <string.h>
 
 namespace rapidrpc {
 
-TcpAcceptor::TcpAcceptor(const NetAddr::s_ptr paddr, int backlog) : m_addr(paddr), m_backlog(backlog) {
+TcpAcceptor::TcpAcceptor(const NetAddr::s_ptr paddr, int backlog, bool reuse_port)
+    : m_addr(paddr), m_backlog(backlog) {
     if (!paddr || !*m_addr) {
         ERRORLOG("Invalid address");
         exit(-1);
@@ -22,6 +26,10 @@ TcpAcceptor::TcpAcceptor(const NetAddr::s_ptr paddr, int backlog) : m_addr(paddr
     if (setsockopt(m_listenfd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) < 0) { // reuse addr
         ERRORLOG("Failed to set reuse addr");
     }
+    if (reuse_port && setsockopt(m_listenfd, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) < 0) {
+        ERRORLOG("Failed to set reuse port, error [%s]", strerror(errno));
+        exit(-1);
+    }
     // nonblock
     // if (isNonBlock) {
     //     int flags = fcntl(m_listenfd, F_GETFL, 0);                // get old flags
@@ -43,52 +51,55 @@ TcpAcceptor::TcpAcceptor(const NetAddr::s_ptr paddr, int backlog) : m_addr(paddr
 }
 TcpAcceptor::~TcpAcceptor() {}
 
-int TcpAcceptor::accept(NetAddr &clientAddr) {
-    if (m_family == AF_INET) {
-        sockaddr_in addr;
-        socklen_t len = sizeof(addr);
-        int clientfd = ::accept(m_listenfd, (sockaddr *)&addr, &len);
-        // TODO: non-blocking
-        if (clientfd < 0 && !(errno == EAGAIN || errno == EWOULDBLOCK)) {
-            ERRORLOG("Failed to accept connection");
-            return -1;
-        }
-
-        static_cast<IpNetAddr &>(clientAddr) = IpNetAddr(addr);
-
-        INFOLOG("Accept connection from %s", clientAddr.toString().c_str());
-        return clientfd;
+bool TcpAcceptor::attachReusePortCpuSteering(int groups) {
+#ifdef SO_ATTACH_REUSEPORT_CBPF
+    // A = 当前 CPU; A = A % groups; return A
+    sock_filter code[] = {
+        {BPF_LD | BPF_W | BPF_ABS, 0, 0, static_cast<uint32_t>(SKF_AD_OFF + SKF_AD_CPU)},
+        {BPF_ALU | BPF_MOD | BPF_K, 0, 0, static_cast<uint32_t>(groups)},
+        {BPF_RET | BPF_A, 0, 0, 0},
+    };
+    sock_fprog prog;
+    prog.len = sizeof(code) / sizeof(code[0]);
+    prog.filter = code;
+    if (groups <= 0 || setsockopt(m_listenfd, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &prog, sizeof(prog)) < 0) {
+        ERRORLOG("Failed to attach reuseport cbpf, groups [%d], error [%s]", groups, strerror(errno));
+        return false;
     }
+    return true;
+#else
+    ERRORLOG("SO_ATTACH_REUSEPORT_CBPF is not supported");
+    return false;
+#endif
+}
 
-    if (m_family == AF_UNIX) {
-        sockaddr_un addr;
-        socklen_t len = sizeof(addr);
-        int clientfd = ::accept(m_listenfd, (sockaddr *)&addr, &len);
-        if (clientfd < 0) {
-            ERRORLOG("Failed to accept connection");
-            return -1;
+int TcpAcceptor::accept(NetAddr &clientAddr, int flags) {
+    sockaddr_storage addr;
+    socklen_t len = sizeof(addr);
+    int clientfd = ::accept4(m_listenfd, reinterpret_cast<sockaddr *>(&addr), &len, flags);
+    if (clientfd < 0) {
+        // 非阻塞模式下 backlog 已经取完
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            ERRORLOG("Failed to accept connection, error [%s]", strerror(errno));
         }
-
-        static_cast<UnixNetAddr &>(clientAddr) = UnixNetAddr(addr);
-        INFOLOG("Accept connection from %s", clientAddr.toString().c_str());
-        return clientfd;
+        return -1;
     }
 
-    if (m_family == AF_INET6) {
-        sockaddr_in6 addr;
-        socklen_t len = sizeof(addr);
-        int clientfd = ::accept(m_listenfd, (sockaddr *)&addr, &len);
-        if (clientfd < 0) {
-            ERRORLOG("Failed to accept connection");
-            return -1;
-        }
-
-        static_cast<Ip6NetAddr &>(clientAddr) = Ip6NetAddr(addr);
-
-        INFOLOG("Accept connection from %s", clientAddr.toString().c_str());
-        return clientfd;
+    if (m_family == AF_INET) {
+        static_cast<IpNetAddr &>(clientAddr) = IpNetAddr(*reinterpret_cast<sockaddr_in *>(&addr));
+    }
+    else if (m_family == AF_UNIX) {
+        static_cast<UnixNetAddr &>(clientAddr) = UnixNetAddr(*reinterpret_cast<sockaddr_un *>(&addr));
+    }
+    else if (m_family == AF_INET6) {
+        static_cast<Ip6NetAddr &>(clientAddr) = Ip6NetAddr(*reinterpret_cast<sockaddr_in6 *>(&addr));
+    }
+    else {
+        ERRORLOG("Unknown address family");
+        ::close(clientfd);
+        return -1;
     }
-    ERRORLOG("Unknown address family");
-    return -1;
+    INFOLOG("Accept connection from %s", clientAddr.toString().c_str());
+    return clientfd;
 }
 } // namespace rapidrpc
\ No newline at end of file
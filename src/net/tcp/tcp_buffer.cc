@@ -7,7 +7,8 @@
 namespace rapidrpc {
 
 TcpBuffer::TcpBuffer(int size) : m_size(size) {
-    m_buffer.reserve(size);
+    // ! resize 而不是 reserve，socket 直接读取到 m_buffer 中，需要保证 m_buffer.size() == m_size
+    m_buffer.resize(size);
 }
 
 TcpBuffer::~TcpBuffer() {}
@@ -97,7 +98,8 @@ void TcpBuffer::moveReadIndex(int size) {
 // TODO: 这个函数作用， read(socket) 需要手动来操作写入指针，读取到缓冲区是由操作系统完成的
 void TcpBuffer::moveWriteIndex(int size) {
     int new_write_index = m_write_index + size;
-    if (new_write_index >= m_size) {
+    // 可以正好写满 buffer(write_index == m_size)
+    if (new_write_index > m_size) {
         ERRORLOG("moveWriteIndex error, invalid size=%d, old write_index=%d, size=%d", size, m_write_index, m_size);
         return;
     }
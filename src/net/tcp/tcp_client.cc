@@ -3,9 +3,11 @@
 #include "rapidrpc/net/tcp/tcp_client.h"
 #include "rapidrpc/net/fd_event_group.h"
 
+#include <unistd.h>
+
 namespace rapidrpc {
 
-TcpClient::TcpClient(NetAddr::s_ptr peer_addr) : m_peer_addr(peer_addr) {
+TcpClient::TcpClient(NetAddr::s_ptr peer_addr, bool edge_triggered) : m_peer_addr(peer_addr) {
     // ! 通过 EventLoop::GetCurrentEventLoop() 获取当前线程的 EventLoop
     m_event_loop = EventLoop::GetCurrentEventLoop();
 
@@ -22,10 +24,16 @@ TcpClient::TcpClient(NetAddr::s_ptr peer_addr) : m_peer_addr(peer_addr) {
 
     // 设置非阻塞
     m_fd_event = FdEventGroup::GetGlobalFdEventGroup()->getFdEvent(m_fd);
+    if (!m_fd_event) {
+        ERRORLOG("TcpClient::TcpClient, no fd event for fd[%d]", m_fd);
+        ::close(m_fd);
+        m_fd = -1;
+        return;
+    }
     m_fd_event->setNonBlocking(); // 可重入
     // TODO: 其中设置了非阻塞，绑定了 m_fd 的读事件等
     m_connection = std::make_shared<TcpConnection>(m_event_loop, m_fd, 1024, m_peer_addr,
-                                                   TcpConnectionType::TcpConnectionByClient);
+                                                   TcpConnectionType::TcpConnectionByClient, edge_triggered);
 }
 
 TcpClient::~TcpClient() {
@@ -40,7 +48,7 @@ TcpClient::~TcpClient() {
 // 异步的连接远程地址 connect to peer_addr
 // 只有 返回 -1 && errno == EINPROGRESS 时，才会注册 OUT_EVENT 事件来监听连接是否成功
 // 最后清除 OUT_EVENT 事件
-void TcpClient::connect(std::function<void()> conn_cb) {
+void TcpClient::connect(Task conn_cb) {
 
     int rt = ::connect(m_fd, m_peer_addr->getSockAddr(), m_peer_addr->getSockAddrLen());
     // rt = 0, connect success || rt < 0, errno == EINPROGRESS, connect in progress
@@ -67,7 +75,9 @@ void TcpClient::connect(std::function<void()> conn_cb) {
         }
         // connect in progress
         // !! 连接前的一次性事件，连接成功或失败后会清除
-        m_fd_event->listen(TriggerEvent::OUT_EVENT, [this, conn_cb]() {
+        // 回调函数保存在成员中，写事件回调只捕获 this，保证可以内联存储
+        m_connect_cb = std::move(conn_cb);
+        m_fd_event->listen(TriggerEvent::OUT_EVENT, [this]() {
             // check connect error by connect again
             int rt = ::connect(m_fd, m_peer_addr->getSockAddr(), m_peer_addr->getSockAddrLen());
             if ((rt < 0 && errno == EISCONN) || rt == 0) {
@@ -96,6 +106,7 @@ void TcpClient::connect(std::function<void()> conn_cb) {
             // !! 否则会导致回调函数中的写事件无法注册/被上面的覆盖(在回调函数中使用 writeMessage
             // 发送数据时会注册写事件)
             // 不管连接成功与否，都会调用回调函数
+            Task conn_cb(std::move(m_connect_cb));
             if (conn_cb) {
                 conn_cb();
             }
@@ -109,22 +120,22 @@ void TcpClient::connect(std::function<void()> conn_cb) {
 }
 
 // 异步的发送数据
-void TcpClient::writeMessage(AbstractProtocol::s_ptr message, std::function<void(AbstractProtocol::s_ptr)> write_cb) {
+void TcpClient::writeMessage(AbstractProtocol::s_ptr message, TcpConnection::MessageCallback write_cb) {
     if (!message)
         return;
     // 1. 写入到 TcpConnection 的等待队列
-    m_connection->addMessage(message, write_cb);
+    m_connection->addMessage(message, std::move(write_cb));
     // 2. 注册写事件，等待写事件触发
     // !! 类似于服务端连接，都是在有数据时添加写事件，发送完毕后清除写事件
     m_connection->listenWriteEvent();
 }
 
 // 异步的读取数据
-void TcpClient::readMessage(const std::string &msg_id, std::function<void(AbstractProtocol::s_ptr)> read_cb) {
+void TcpClient::readMessage(const std::string &msg_id, TcpConnection::MessageCallback read_cb) {
     // 1. 监听可读事件
     // 2. 读取数据，并解码出 message 对象
 
-    m_connection->addReadCb(msg_id, read_cb);
+    m_connection->addReadCb(msg_id, std::move(read_cb));
     // TODO: 每次读取后，需要清除读事件吗？
     m_connection->listenReadEvent();
 }
@@ -9,9 +9,11 @@
 #include "rapidrpc/net/tcp/tcp_connection.h"
 #include "rapidrpc/net/fd_event_group.h"
 #include "rapidrpc/common/log.h"
+#include "rapidrpc/common/config.h"
 #include "rapidrpc/net/coder/string_coder.h"
 #include "rapidrpc/net/coder/tinypb_coder.h"
 
+#include <sys/socket.h>
 #include <fcntl.h>
 #include <unistd.h>
 #include <string.h>
@@ -19,29 +21,63 @@
 namespace rapidrpc {
 
 TcpConnection::TcpConnection(EventLoop *event_loop, int fd, int buffer_size, NetAddr::s_ptr peer_addr,
-                             TcpConnectionType conn_type /*= TcpConnectionType::TcpConnectionByServer */)
+                             TcpConnectionType conn_type /*= TcpConnectionType::TcpConnectionByServer */,
+                             bool edge_triggered /*= false */)
     : m_peer_addr(peer_addr), m_event_loop(event_loop), m_state(TcpState::NotConnected), m_conn_type(conn_type) {
 
-    m_in_buffer = std::make_shared<TcpBuffer>(buffer_size);
-    m_out_buffer = std::make_shared<TcpBuffer>(buffer_size);
+    m_edge_triggered = edge_triggered && m_event_loop->isEdgeTriggeredSupported();
+    if (edge_triggered && !m_edge_triggered) {
+        INFOLOG("poller does not support edge triggered mode, use level triggered, fd=[%d]", fd);
+    }
+
+    if (Config::GetGlobalConfig()) {
+        m_read_budget = Config::GetGlobalConfig()->m_conn_read_budget;
+    }
+
+    // 连接总是在所在的 IO 线程中创建(TcpServer::addConnection / TcpClient), 缓冲区在 IO 线程中分配和首次访问,
+    // IO 线程绑定 CPU 时位于其本地 NUMA 节点
+    initBuffers(buffer_size);
 
     // set non-blocking
     // ! 如果需要一次读完，非阻塞模式更容易判断；阻塞使用超时时间或者使用上层协议格式
+    // 服务端连接由 TcpServer 通过 accept4(SOCK_NONBLOCK) 创建，已经是非阻塞的，不需要再 fcntl
     m_fd_event = FdEventGroup::GetGlobalFdEventGroup()->getFdEvent(fd);
-    m_fd_event->setNonBlocking();
+    if (!m_fd_event) {
+        // fd 超出 FdEventGroup 的范围, 连接不可用，由创建者关闭 fd
+        ERRORLOG("TcpConnection::TcpConnection, no fd event for fd=[%d]", fd);
+        m_state = TcpState::Closed;
+        return;
+    }
+    if (m_conn_type == TcpConnectionType::TcpConnectionByClient) {
+        m_fd_event->setNonBlocking();
+    }
 
     // m_coder = std::make_shared<StringCoder>();
     m_coder = std::make_shared<TinyPBCoder>();
 
     // 设置读事件回调函数并添加到 epoll 中（TcpConnectionByServer）
+    // 出错/挂断时直接关闭连接；客户端连接失败由 TcpClient::connect 的写回调处理
     if (m_conn_type == TcpConnectionType::TcpConnectionByServer) {
-        listenReadEvent();
+        // accept 返回时已经建立连接，必须在添加到 epoll 之前设置状态:
+        // IO 线程可能立即触发可读事件，边缘触发模式下此时丢弃的事件不会再次触发
+        m_state = TcpState::Connected;
+        // 在 accept 的线程中立即计入 EventLoop 的负载，下一个新连接选择 IO 线程时可以看到
+        // 只统计服务端连接，关闭(clear)时减去
+        m_load_counted = true;
+        m_event_loop->addConnectionCount(1);
+        m_fd_event->listen(TriggerEvent::ERROR_EVENT, std::bind(&TcpConnection::onError, this));
+        if (m_edge_triggered) {
+            listenEdgeTriggered();
+        }
+        else {
+            listenReadEvent();
+        }
     }
 }
 
 TcpConnection::~TcpConnection() {
     DEBUGLOG("TcpConnection::~TcpConnection, peer_addr=[%s], fd=[%d]", m_peer_addr->toString().c_str(),
-             m_fd_event->getFd());
+             m_fd_event ? m_fd_event->getFd() : -1);
 }
 
 void TcpConnection::onRead() {
@@ -52,6 +88,10 @@ void TcpConnection::onRead() {
         return;
     }
     // 读取数据, 非阻塞模式下尽可能读取；（如果是阻塞模式由于是 LT 模式，会一直触发，直到读完）
+    // 边缘触发模式必须读取直到 EAGAIN，否则剩余的数据不会再触发可读事件
+    // 设置了读取预算时，超出预算后先处理已读取的数据，剩余数据下一轮读取，避免一个连接占用整个 IO 线程
+    int read_bytes = 0;
+    bool budget_exhausted = false;
     while (true) {
         //
         if (m_in_buffer->writeAvailable() == 0) {
@@ -61,6 +101,9 @@ void TcpConnection::onRead() {
         // read data from socket
         int write_index = m_in_buffer->writeIndex();
         int free_len = m_in_buffer->writeAvailable(); // 最多读取 free_len 字节, 保证 moveWriteIndex 也不会越界
+        if (m_read_budget > 0 && free_len > m_read_budget - read_bytes) {
+            free_len = m_read_budget - read_bytes;
+        }
         int n = read(m_fd_event->getFd(), &m_in_buffer->m_buffer[write_index], free_len);
 
         DEBUGLOG("success read %d bytes from addr[%s], clientfd[%d]", n, m_peer_addr->toString().c_str(),
@@ -83,24 +126,36 @@ void TcpConnection::onRead() {
         // move write index
         m_in_buffer->moveWriteIndex(n); // n>=0
 
-        if (n < free_len) {
+        if (n == 0 || (!m_edge_triggered && n < free_len)) {
             // 读取完毕
             break;
         }
+        read_bytes += n;
+        if (m_read_budget > 0 && read_bytes >= m_read_budget) {
+            budget_exhausted = true;
+            break;
+        }
     }
     // ! Close the connection
     if (m_state == TcpState::Closed) {
-        // TODO: 关闭连接, 调用 fd_event 的 close
-        m_event_loop->deleteEpollEvent(m_fd_event);
-        m_fd_event->close();
-        if (m_remove_conn_cb) {
-            m_remove_conn_cb();
-        }
         INFOLOG("peer close connection, addr[%s], clientfd[%d]", m_peer_addr->toString().c_str(), m_fd_event->getFd());
+        clear();
         return;
     }
 
     execute();
+
+    // 水平触发模式下一轮 epoll_wait 会再次返回可读事件；
+    // 边缘触发模式剩余的数据不会再触发，添加到任务队列，下一轮循环继续读取(连接可能在此之前关闭)
+    if (budget_exhausted && m_edge_triggered) {
+        w_ptr conn = weak_from_this();
+        m_event_loop->addTask([conn]() {
+            s_ptr c = conn.lock();
+            if (c && c->getState() == TcpState::Connected) {
+                c->onRead();
+            }
+        });
+    }
 }
 
 // * 执行请求
@@ -116,13 +171,25 @@ void TcpConnection::execute() {
             return;
         }
 
+        Dispatcher *dispatcher = Dispatcher::GetDispatcher();
         for (size_t i = 0; i < requests.size(); i++) {
             TinyPBProtocol::s_ptr response = std::make_shared<TinyPBProtocol>();
-            Dispatcher::GetDispatcher()->dispatch(requests[i], response);
+            if (dispatcher->isPooled(requests[i])) {
+                // 在业务线程池中执行，完成后在本 IO 线程中发送响应(客户端按 msg_id 匹配，不要求顺序)
+                if (dispatchToWorker(requests[i], response)) {
+                    continue;
+                }
+                // 队列已满，直接返回错误, 不在 IO 线程中执行
+                dispatcher->reject(requests[i], response, Error::SYS_SERVER_BUSY, "server busy, worker queue full");
+            }
+            else {
+                dispatcher->dispatch(requests[i], response);
+            }
             responses.push_back(response);
         }
-        m_coder->encode(responses, m_out_buffer);
-        listenWriteEvent();
+        if (!responses.empty()) {
+            reply(responses);
+        }
     }
     else {
         // 客户端连接
@@ -168,7 +235,8 @@ void TcpConnection::onWrite() {
     while (true) {
         int read_index = m_out_buffer->readIndex();
         int len = m_out_buffer->readAvailable();
-        int n = write(m_fd_event->getFd(), &m_out_buffer->m_buffer[read_index], len);
+        // 对端已经关闭时返回 EPIPE 而不是触发 SIGPIPE 终止进程, 连接由随后的错误/挂断事件关闭
+        int n = send(m_fd_event->getFd(), &m_out_buffer->m_buffer[read_index], len, MSG_NOSIGNAL);
 
         DEBUGLOG("success write %d bytes to addr[%s], clientfd[%d]", n, m_peer_addr->toString().c_str(),
                  m_fd_event->getFd());
@@ -180,6 +248,7 @@ void TcpConnection::onWrite() {
             }
             else {
                 ERRORLOG("Error on write, err[%s]", strerror(errno));
+                updateQueuedBytes();
                 return;
             }
         }
@@ -188,14 +257,18 @@ void TcpConnection::onWrite() {
 
         if (n >= len) {
             // 写完数据
-            // clear write event
-            m_fd_event->clearEvent(TriggerEvent::OUT_EVENT);
-            // 重新添加到 epoll 中, 已经存在的事件会被更新
-            m_event_loop->addEpollEvent(m_fd_event);
+            // 边缘触发模式可写事件一直注册，只在发送缓冲区由满变为可写时触发
+            if (!m_edge_triggered) {
+                // clear write event
+                m_fd_event->clearEvent(TriggerEvent::OUT_EVENT);
+                // 重新添加到 epoll 中, 已经存在的事件会被更新
+                m_event_loop->addEpollEvent(m_fd_event);
+            }
             break;
         }
         // n<len，尝试继续写
     }
+    updateQueuedBytes();
 
     // TODO: 对客户端的写入数据后的回调函数执行
     // * 只能保证将客户端原始数据编码后的数据保存到 m_out_buffer 发送缓冲区中后依次执行回调函数
@@ -207,6 +280,85 @@ void TcpConnection::onWrite() {
     }
 }
 
+void TcpConnection::onError() {
+    int err = 0;
+    socklen_t len = sizeof(err);
+    getsockopt(m_fd_event->getFd(), SOL_SOCKET, SO_ERROR, &err, &len);
+    INFOLOG("connection error or hang up, addr[%s], clientfd[%d], err[%s]", m_peer_addr->toString().c_str(),
+            m_fd_event->getFd(), strerror(err));
+    m_state = TcpState::Closed;
+    clear();
+}
+
+// !! m_remove_conn_cb 会释放本连接对象，之后不能再访问成员
+void TcpConnection::clear() {
+    m_event_loop->deleteEpollEvent(m_fd_event);
+    m_fd_event->close();
+    releaseLoad();
+    if (m_remove_conn_cb) {
+        m_remove_conn_cb();
+    }
+}
+
+bool TcpConnection::dispatchToWorker(AbstractProtocol::s_ptr request, AbstractProtocol::s_ptr response) {
+    w_ptr conn = weak_from_this();
+    EventLoop *event_loop = m_event_loop;
+    // 响应回到本线程之前 EventLoop 不能被释放(IOThreadGroup 排空线程)
+    event_loop->addPendingReplies(1);
+    auto task = [conn, event_loop, request, response]() {
+        Dispatcher::GetDispatcher()->dispatch(request, response);
+        // 回到连接所在的 IO 线程编码和发送, 连接已经关闭时丢弃
+        event_loop->addTask(
+            [conn, event_loop, response]() {
+                event_loop->addPendingReplies(-1);
+                s_ptr c = conn.lock();
+                if (c && c->getState() == TcpState::Connected) {
+                    std::vector<AbstractProtocol::s_ptr> responses{response};
+                    c->reply(responses);
+                }
+            },
+            true);
+    };
+    if (!Dispatcher::GetDispatcher()->getWorkerPool()->submit(std::move(task))) {
+        event_loop->addPendingReplies(-1);
+        return false;
+    }
+    return true;
+}
+
+void TcpConnection::reply(std::vector<AbstractProtocol::s_ptr> &responses) {
+    m_coder->encode(responses, m_out_buffer);
+    listenWriteEvent();
+    updateQueuedBytes();
+}
+
+void TcpConnection::initBuffers(int buffer_size) {
+    m_in_buffer = std::make_shared<TcpBuffer>(buffer_size);
+    m_out_buffer = std::make_shared<TcpBuffer>(buffer_size);
+}
+
+void TcpConnection::updateQueuedBytes() {
+    if (!m_load_counted) {
+        return;
+    }
+    int64_t queued = m_out_buffer->readAvailable();
+    if (queued != m_queued_bytes) {
+        m_event_loop->addQueuedBytes(queued - m_queued_bytes);
+        m_queued_bytes = queued;
+    }
+}
+
+// 连接关闭时从 EventLoop 的负载中减去, 只执行一次
+void TcpConnection::releaseLoad() {
+    if (!m_load_counted) {
+        return;
+    }
+    m_load_counted = false;
+    m_event_loop->addConnectionCount(-1);
+    m_event_loop->addQueuedBytes(-m_queued_bytes);
+    m_queued_bytes = 0;
+}
+
 void TcpConnection::setState(const TcpState state) {
     m_state = state;
 }
@@ -222,33 +374,50 @@ void TcpConnection::shutdown() {
 
     // shut_rdwr 关闭了读写，对端会收到 FIN
     ::shutdown(m_fd_event->getFd(), SHUT_RDWR);
-    m_event_loop->deleteEpollEvent(m_fd_event);
-    m_fd_event->close();
-    if (m_remove_conn_cb) {
-        m_remove_conn_cb();
-    }
+    clear();
 }
 
-void TcpConnection::setRemoveConnCb(std::function<void()> &&remove_conn_cb) {
+void TcpConnection::setRemoveConnCb(Task &&remove_conn_cb) {
     m_remove_conn_cb = std::move(remove_conn_cb);
 }
 
 void TcpConnection::listenWriteEvent() {
+    if (m_edge_triggered) {
+        listenEdgeTriggered();
+        // 可写事件只在状态变化时触发，直接发送，未发送完的数据等待下次可写事件
+        onWrite();
+        return;
+    }
     m_fd_event->listen(TriggerEvent::OUT_EVENT, std::bind(&TcpConnection::onWrite, this));
     m_event_loop->addEpollEvent(m_fd_event); //!!重新添加到 epoll 中(修改监听的事件)
 }
 
 void TcpConnection::listenReadEvent() {
+    if (m_edge_triggered) {
+        listenEdgeTriggered();
+        return;
+    }
+    m_fd_event->listen(TriggerEvent::IN_EVENT, std::bind(&TcpConnection::onRead, this));
+    m_event_loop->addEpollEvent(m_fd_event);
+}
+
+void TcpConnection::listenEdgeTriggered() {
+    // 已经以边缘触发模式注册(客户端连接时 TcpClient 会临时监听可写事件，连接后删除)
+    if (m_fd_event->isRegistered() && (m_fd_event->getRegisteredEvents() & EPOLLET)) {
+        return;
+    }
     m_fd_event->listen(TriggerEvent::IN_EVENT, std::bind(&TcpConnection::onRead, this));
+    m_fd_event->listen(TriggerEvent::OUT_EVENT, std::bind(&TcpConnection::onWrite, this));
+    m_fd_event->setEdgeTriggered(true);
     m_event_loop->addEpollEvent(m_fd_event);
 }
 
-void TcpConnection::addMessage(AbstractProtocol::s_ptr message, std::function<void(AbstractProtocol::s_ptr)> write_cb) {
-    m_write_cb.emplace_back(message, write_cb);
+void TcpConnection::addMessage(AbstractProtocol::s_ptr message, MessageCallback write_cb) {
+    m_write_cb.emplace_back(message, std::move(write_cb));
 }
 
-void TcpConnection::addReadCb(const std::string &msg_id, std::function<void(AbstractProtocol::s_ptr)> read_cb) {
-    m_read_cb[msg_id] = read_cb;
+void TcpConnection::addReadCb(const std::string &msg_id, MessageCallback read_cb) {
+    m_read_cb[msg_id] = std::move(read_cb);
 }
 
 NetAddr::s_ptr TcpConnection::getLocalAddr() const {
@@ -1,8 +1,15 @@
 #include "rapidrpc/net/tcp/tcp_server.h"
 #include "rapidrpc/common/log.h"
 #include "rapidrpc/common/config.h"
+#include "rapidrpc/common/util.h"
 #include "rapidrpc/net/fd_event_group.h"
 
+#include <sys/socket.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <algorithm>
+
 namespace rapidrpc {
 
 TcpServer::TcpServer(NetAddr::s_ptr local_addr) : m_local_addr(local_addr) {
@@ -24,42 +31,174 @@ TcpServer::~TcpServer() {
 };
 
 void TcpServer::init() {
-    m_acceptor = std::make_shared<TcpAcceptor>(m_local_addr); // 创建一个 Acceptor 对象, bind and listen
-    m_main_event_loop = EventLoop::GetCurrentEventLoop();     // mainReactor 静态创建一个Loop
+    // 主线程运行 accept 的 EventLoop, 配置了 main_thread_cpus 时在创建 EventLoop 之前绑定 CPU
+    // 主线程属于使用者的进程, 不修改线程名称
+    if (!Config::GetGlobalConfig()->m_main_thread_cpus.empty()) {
+        std::vector<int> cpus = parseCpuList(Config::GetGlobalConfig()->m_main_thread_cpus);
+        if (cpus.empty()) {
+            ERRORLOG("Invalid main_thread_cpus [%s]", Config::GetGlobalConfig()->m_main_thread_cpus.c_str());
+        }
+        else {
+            IOThread::BindCurrentThread("main", cpus);
+        }
+    }
+
+    m_main_event_loop = EventLoop::GetCurrentEventLoop(); // mainReactor 静态创建一个Loop
+    m_accept_batch = std::max(1, Config::GetGlobalConfig()->m_accept_batch);
+
+    // 业务线程池: 配置的服务在线程池中执行，不阻塞 IO 线程
+    if (Config::GetGlobalConfig()->m_worker_threads > 0) {
+        Dispatcher *dispatcher = Dispatcher::GetDispatcher();
+        dispatcher->initWorkerPool(Config::GetGlobalConfig()->m_worker_threads,
+                                   Config::GetGlobalConfig()->m_worker_queue_size,
+                                   Config::GetGlobalConfig()->m_worker_scheduler);
+        const std::string &services = Config::GetGlobalConfig()->m_pooled_services;
+        size_t pos = 0;
+        while (pos < services.size()) {
+            size_t end = services.find(',', pos);
+            if (end == std::string::npos) {
+                end = services.size();
+            }
+            if (end > pos) {
+                dispatcher->setServicePooled(services.substr(pos, end - pos), true);
+            }
+            pos = end + 1;
+        }
+    }
 
     // 读取配置， 创建 IOThreadGroup 对象
     m_io_thread_group = new IOThreadGroup(Config::GetGlobalConfig()->m_io_threads);
 
+    const std::string &accept_mode = Config::GetGlobalConfig()->m_accept_mode;
+    if (accept_mode == "reuseport" || accept_mode == "reuseport_cbpf") {
+        if (initReusePortAcceptors(accept_mode == "reuseport_cbpf")) {
+            return;
+        }
+    }
+    else if (accept_mode != "main") {
+        ERRORLOG("Unknown accept mode [%s], use main", accept_mode.c_str());
+    }
+
+    // 创建一个 Acceptor 对象, bind and listen
+    m_acceptor = std::make_shared<TcpAcceptor>(m_local_addr, Config::GetGlobalConfig()->m_listen_backlog);
     m_listen_fd_event = FdEventGroup::GetGlobalFdEventGroup()->getFdEvent(m_acceptor->getListenFd());
+    if (!m_listen_fd_event) {
+        ERRORLOG("No fd event for listenfd[%d]", m_acceptor->getListenFd());
+        exit(-1);
+    }
     // ! set non-blocking
     m_listen_fd_event->setNonBlocking();
-    m_listen_fd_event->listen(TriggerEvent::IN_EVENT, std::bind(&TcpServer::onAccept, this));
+    m_listen_fd_event->listen(TriggerEvent::IN_EVENT, std::bind(&TcpServer::onAccept, this, m_acceptor, nullptr));
     // add listen_fd_event to mainReactor
     m_main_event_loop->addEpollEvent(m_listen_fd_event);
+
+    // 自动调整 IO 线程数; 没有开启时在排空线程时才添加定时器
+    if (Config::GetGlobalConfig()->m_io_autoscale_interval_ms > 0) {
+        armResizeTimer();
+    }
 }
 
-void TcpServer::onAccept() {
-    // nothing to do with client_addr, just for accept
-    NetAddr::s_ptr client_addr;
-    if (m_acceptor->getFamily() == AF_INET) {
-        client_addr = std::make_shared<IpNetAddr>();
+bool TcpServer::initReusePortAcceptors(bool cpu_steering) {
+    int family = m_local_addr->getFamily();
+    if (family != AF_INET && family != AF_INET6) {
+        ERRORLOG("SO_REUSEPORT accept mode needs an ip address, [%s] use main", m_local_addr->toString().c_str());
+        return false;
     }
-    else if (m_acceptor->getFamily() == AF_INET6) {
-        client_addr = std::make_shared<Ip6NetAddr>();
+
+    // 在主线程中按 IO 线程的顺序 listen, socket 在 SO_REUSEPORT 组中的序号与 IO 线程序号一致
+    int size = m_io_thread_group->getSize();
+    for (int i = 0; i < size; i++) {
+        m_reuseport_acceptors.push_back(
+            std::make_shared<TcpAcceptor>(m_local_addr, Config::GetGlobalConfig()->m_listen_backlog, true));
     }
-    else {
-        client_addr = std::make_shared<UnixNetAddr>();
+    if (cpu_steering) {
+        m_reuseport_acceptors[0]->attachReusePortCpuSteering(size);
+    }
+
+    for (int i = 0; i < size; i++) {
+        TcpAcceptor::s_ptr acceptor = m_reuseport_acceptors[i];
+        IOThread *io_thread = m_io_thread_group->getIOThread(i);
+        FdEvent *fd_event = FdEventGroup::GetGlobalFdEventGroup()->getFdEvent(acceptor->getListenFd());
+        if (!fd_event) {
+            ERRORLOG("No fd event for listenfd[%d]", acceptor->getListenFd());
+            exit(-1);
+        }
+        fd_event->setNonBlocking();
+        fd_event->listen(TriggerEvent::IN_EVENT, std::bind(&TcpServer::onAccept, this, acceptor, io_thread));
+        // IO 线程的 EventLoop 还没有运行, 添加任务在 loop 开始后执行
+        io_thread->getEventLoop()->addEpollEvent(fd_event);
     }
-    int client_fd = m_acceptor->accept(*client_addr); // accept connection
-    if (client_fd < 0) {
-        ERRORLOG("Failed to accept connection");
+    INFOLOG("TcpServer accept mode [%s], %d listeners on [%s]", cpu_steering ? "reuseport_cbpf" : "reuseport", size,
+            m_local_addr->toString().c_str());
+    return true;
+}
+
+void TcpServer::onAccept(TcpAcceptor::s_ptr acceptor, IOThread *io_thread) {
+    // 分配给其他 IO 线程的连接, 每个线程一个任务
+    std::vector<std::pair<IOThread *, std::vector<std::pair<int, NetAddr::s_ptr>>>> batches;
+    int so_busy_poll_us = Config::GetGlobalConfig()->m_so_busy_poll_us;
+
+    for (int i = 0; i < m_accept_batch; i++) {
+        // nothing to do with client_addr, just for accept
+        NetAddr::s_ptr client_addr;
+        if (acceptor->getFamily() == AF_INET) {
+            client_addr = std::make_shared<IpNetAddr>();
+        }
+        else if (acceptor->getFamily() == AF_INET6) {
+            client_addr = std::make_shared<Ip6NetAddr>();
+        }
+        else {
+            client_addr = std::make_shared<UnixNetAddr>();
+        }
+        // accept connection, 新 fd 直接设置为非阻塞
+        int client_fd = acceptor->accept(*client_addr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (client_fd < 0) {
+            // backlog 已经取完或者出错
+            break;
+        }
+        // 低延迟: 阻塞读取/轮询时在驱动中自旋等待数据
+        if (so_busy_poll_us > 0
+            && setsockopt(client_fd, SOL_SOCKET, SO_BUSY_POLL, &so_busy_poll_us, sizeof(so_busy_poll_us)) < 0) {
+            ERRORLOG("Failed to set SO_BUSY_POLL on clientfd[%d], err[%s]", client_fd, strerror(errno));
+        }
+
+        // add conn(client_fd) to IOThread, SO_REUSEPORT 模式下就是当前线程
+        IOThread *target = io_thread ? io_thread : m_io_thread_group->getIOThread(); // get next IOThread
+        EventLoop *event_loop = target->getEventLoop();
+        if (event_loop->isInLoopThread()) {
+            addConnection(event_loop, client_fd, client_addr);
+            continue;
+        }
+        // 先计入负载，同一批中后面的连接选择 IO 线程时可以看到，创建连接时减去
+        event_loop->addConnectionCount(1);
+        auto it = std::find_if(batches.begin(), batches.end(), [target](const auto &b) { return b.first == target; });
+        if (it == batches.end()) {
+            batches.emplace_back(target, std::vector<std::pair<int, NetAddr::s_ptr>>());
+            it = batches.end() - 1;
+        }
+        it->second.emplace_back(client_fd, client_addr);
+    }
+
+    for (auto &batch : batches) {
+        EventLoop *event_loop = batch.first->getEventLoop();
+        auto callback = [this, event_loop, conns = std::move(batch.second)]() {
+            for (auto &conn : conns) {
+                event_loop->addConnectionCount(-1);
+                addConnection(event_loop, conn.first, conn.second);
+            }
+        };
+        event_loop->addTask(std::move(callback), true);
+    }
+}
+
+void TcpServer::addConnection(EventLoop *event_loop, int client_fd, NetAddr::s_ptr client_addr) {
+    TcpConnection::s_ptr conn = std::make_shared<TcpConnection>(
+        event_loop, client_fd, 1024, client_addr, TcpConnectionType::TcpConnectionByServer, m_edge_triggered);
+    if (conn->getState() == TcpState::Closed) {
+        // 没有注册监听事件，直接关闭
+        ::close(client_fd);
         return;
     }
-    // add conn(client_fd) to IOThread
-    IOThread *io_thread = m_io_thread_group->getIOThread(); // get next IOThread
-    TcpConnection::s_ptr conn =
-        std::make_shared<TcpConnection>(io_thread->getEventLoop(), client_fd, 1024, client_addr);
-    conn->setState(TcpState::Connected);
     // ! set callback
     conn->setRemoveConnCb(std::bind(&TcpServer::removeConnection, this, TcpConnection::w_ptr(conn)));
     // add connection to set and increase client counts
@@ -70,11 +209,111 @@ void TcpServer::onAccept() {
     }
 }
 
+IOThread *TcpServer::addIOThread() {
+    if (isReusePort()) {
+        ERRORLOG("TcpServer can not add io thread in SO_REUSEPORT accept mode");
+        return nullptr;
+    }
+    return m_io_thread_group->addIOThread();
+}
+
+bool TcpServer::drainIOThread(IOThread *thread) {
+    if (isReusePort()) {
+        ERRORLOG("TcpServer can not drain io thread in SO_REUSEPORT accept mode");
+        return false;
+    }
+    if (!m_io_thread_group->drainIOThread(thread)) {
+        return false;
+    }
+    // 排空的线程由主线程的定时器释放
+    if (m_main_event_loop->isInLoopThread()) {
+        armResizeTimer();
+    }
+    else {
+        m_main_event_loop->addTask([this]() { armResizeTimer(); }, true);
+    }
+    return true;
+}
+
+void TcpServer::armResizeTimer() {
+    if (m_resize_timer) {
+        return;
+    }
+    // 没有开启自动调整时每秒检查一次排空的线程
+    int interval = Config::GetGlobalConfig()->m_io_autoscale_interval_ms;
+    m_resize_timer = std::make_shared<TimerEvent>(interval > 0 ? interval : 1000, true,
+                                                  std::bind(&TcpServer::onResizeTimer, this));
+    m_main_event_loop->addTimerEvent(m_resize_timer);
+}
+
+void TcpServer::onResizeTimer() {
+    Config *config = Config::GetGlobalConfig();
+    if (config->m_io_autoscale_interval_ms > 0) {
+        IOThreadAutoscale policy;
+        policy.m_min_threads = std::max(1, config->m_io_threads_min);
+        policy.m_max_threads = config->m_io_threads_max > 0 ? config->m_io_threads_max : config->m_io_threads;
+        policy.m_high_permille = config->m_io_autoscale_high_permille;
+        policy.m_low_permille = config->m_io_autoscale_low_permille;
+        m_io_thread_group->autoscale(policy);
+    }
+
+    if (config->m_io_drain_timeout_ms > 0) {
+        for (auto &thread : m_io_thread_group->getDrainExpired(config->m_io_drain_timeout_ms)) {
+            INFOLOG("TcpServer drain timeout, close connections of loop [%p]", thread->getEventLoop());
+            closeConnections(thread->getEventLoop());
+        }
+    }
+
+    int reaped = m_io_thread_group->reapDrained();
+    if (reaped > 0) {
+        INFOLOG("TcpServer released %d drained io threads, io threads [%d]", reaped, m_io_thread_group->getSize());
+    }
+
+    // 排空结束, 之后再排空时重新添加
+    if (config->m_io_autoscale_interval_ms <= 0 && m_io_thread_group->getDrainingCount() == 0) {
+        m_main_event_loop->deleteTimerEvent(m_resize_timer);
+        m_resize_timer.reset();
+    }
+}
+
+void TcpServer::closeConnections(EventLoop *event_loop) {
+    std::vector<TcpConnection::s_ptr> conns;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto &conn : m_connections) {
+            if (conn->getEventLoop() == event_loop) {
+                conns.push_back(conn);
+            }
+        }
+    }
+    if (conns.empty()) {
+        return;
+    }
+    // 连接只能在所在的 IO 线程中关闭
+    event_loop->addTask(
+        [conns = std::move(conns)]() {
+            for (auto &conn : conns) {
+                if (conn->getState() == TcpState::Connected) {
+                    conn->shutdown();
+                }
+            }
+        },
+        true);
+}
+
 void TcpServer::start() {
     m_io_thread_group->start(); // 启动所有子线程的 EventLoop
     m_main_event_loop->loop();  // 启动主线程的 EventLoop
 };
 
+IOThreadGroup *TcpServer::getIOThreadGroup() const {
+    return m_io_thread_group;
+}
+
+void TcpServer::setEdgeTriggered(bool value) {
+    m_edge_triggered = value;
+}
+
 void TcpServer::removeConnection(TcpConnection::w_ptr conn) {
     auto tmp_ptr = conn.lock();
     if (!tmp_ptr) {
@@ -4,6 +4,7 @@
 
 #include <sys/timerfd.h> // timerfd_create
 #include <string.h>      // strerror
+#include <algorithm>     // remove_if
 
 namespace rapidrpc {
 
@@ -22,7 +23,12 @@ Timer::Timer() : FdEvent() {
     listen(TriggerEvent::IN_EVENT, std::bind(&Timer::onTimer, this));
 }
 
-Timer::~Timer() {}
+Timer::~Timer() {
+    if (m_wheel) {
+        delete m_wheel;
+        m_wheel = nullptr;
+    }
+}
 
 // TODO: 优化
 void Timer::onTimer() {
@@ -30,23 +36,37 @@ void Timer::onTimer() {
     uint64_t exp; // 超时次数
     while ((read(m_fd, &exp, sizeof(exp)) == -1) && errno == EAGAIN)
         ;
-    // 比较当前时间
-    int64_t now = getNowMs();
+    // 比较当前时间(单调时钟 us), 使用本轮循环等待事件返回时缓存的时间
+    int64_t now = getCachedMonotonicUs();
     std::vector<TimerEvent::s_ptr> events;
-    {
-        std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_wheel) {
+        m_wheel->advance(now, events);
+        // 只调用 setCanceled 取消的任务也会留在时间轮中直到到期
+        events.erase(std::remove_if(events.begin(), events.end(),
+                                    [](const TimerEvent::s_ptr &event) { return event->isCanceled(); }),
+                     events.end());
+        for (auto &event : events) {
+            m_lag_histogram.record(now - event->getArriveTime());
+        }
+        resetWheelTimer();
+    }
+    else {
+        m_armed_time = 0; // timerfd 已经到期
         auto it = m_pending_events.begin();
         while (it != m_pending_events.end() && it->first <= now) {
-            // TODO: 读写冲突，是否需要加锁
+            it->second->m_in_map = false;
             if (!it->second->isCanceled()) {
                 events.push_back(it->second);
+                m_lag_histogram.record(now - it->first);
             }
             it++;
         }
         m_pending_events.erase(m_pending_events.begin(), it); // 指针形式不会影响已有的迭代器失效
     }
-    // 由于清掉了部分任务，重置 timerfd 的唤醒时间
-    resetTimer();
+    // 由于清掉了部分任务，重置 timerfd 的唤醒时间(本轮循环结束后)
+    if (!m_wheel) {
+        markReset();
+    }
 
     // 对于重复任务，重新添加到定时任务中
     for (auto &event : events) {
@@ -58,103 +78,193 @@ void Timer::onTimer() {
     }
     // 执行定时任务
     for (auto &event : events) {
-        if (event->getTask()) {
-            event->getTask()();
-        }
+        event->runTask();
+    }
+}
+
+void Timer::markReset() {
+    if (m_reset_pending) {
+        // 本轮已经需要重新设置，合并
+        addSettimeSaved();
     }
+    m_reset_pending = true;
+}
+
+void Timer::addSettimeSaved() {
+    m_settime_saved.store(m_settime_saved.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+void Timer::flushTimerfd() {
+    if (m_reset_pending && !m_wheel) {
+        resetTimer();
+    }
+}
+
+void Timer::setSlack(int64_t slack_us) {
+    m_slack_us = slack_us > 0 ? slack_us : 0;
+}
+
+int Timer::settime(int flags, const struct itimerspec *new_value) {
+    m_settime_calls.store(m_settime_calls.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    int rt = timerfd_settime(m_fd, flags, new_value, nullptr);
+    if (rt < 0) {
+        ERRORLOG("timerfd_settime failed, error [%s]", strerror(errno));
+    }
+    return rt;
 }
 
 void Timer::resetTimer() {
     // 设置 timerfd 的唤醒时间, 即将最近的到达时间设置为 timerfd 的唤醒时间
-    // 发生在添加定时任务时/删除定时任务时
-    std::pair<int64_t, TimerEvent::s_ptr> tmp;
-    {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        if (m_pending_events.empty()) {
-            // stop timerfd (优化删除时停用timerfd)
-            struct itimerspec new_value;
-            memset(&new_value, 0, sizeof(new_value)); // stop timerfd
-            int rt = timerfd_settime(m_fd, 0, &new_value, nullptr);
-            if (rt < 0) {
-                ERRORLOG("timerfd_settime failed, error [%s]", strerror(errno));
-            }
-            return;
-        }
-        tmp = *m_pending_events.begin();
+    // 发生在添加定时任务时/删除定时任务时/定时器到期后, 由 flushTimerfd 每轮循环最多调用一次
+    m_reset_pending = false;
+    if (m_pending_events.empty()) {
+        // 不关闭 timerfd: 之后添加的任务(如 RPC 超时)通常更晚到达，提前唤醒一次时没有任务执行，比每次删除时关闭代价更小
+        addSettimeSaved();
+        return;
     }
-    int64_t now = getNowMs();
-    int64_t interval = 100; // 100ms 立即执行的间隔时间
-    if (tmp.first > now) {
-        interval = tmp.first - now;
+    // 向上取整到 slack 的整数倍, 窗口内的到达时间共用一次唤醒
+    int64_t arrive_time = m_pending_events.begin()->first;
+    if (m_slack_us > 0) {
+        arrive_time = (arrive_time + m_slack_us - 1) / m_slack_us * m_slack_us;
     }
-    // 设置 timerfd 的唤醒时间
+    // 已经设置为更早(或相同)的唤醒时间，不重新设置; 提前唤醒时 onTimer 再设置
+    if (m_armed_time != 0 && m_armed_time <= arrive_time) {
+        addSettimeSaved();
+        return;
+    }
+    // 设置 timerfd 的唤醒时间: 到达时间与 timerfd 都是 CLOCK_MONOTONIC, 直接设置绝对时间，不需要读取当前时间
+    // 已经到达的时间点会立即触发
     struct itimerspec new_value;
     new_value.it_interval.tv_sec = new_value.it_interval.tv_nsec = 0; // no repeat
-    new_value.it_value.tv_sec = interval / 1000;
-    new_value.it_value.tv_nsec = (interval % 1000) * 1000000;
-    int rt = timerfd_settime(m_fd, 0, &new_value, nullptr); // flags = 0 默认相对当前的调用时间
-    if (rt < 0) {
-        ERRORLOG("timerfd_settime failed");
+    new_value.it_value.tv_sec = arrive_time / 1000000;
+    new_value.it_value.tv_nsec = (arrive_time % 1000000) * 1000;
+    if (settime(TFD_TIMER_ABSTIME, &new_value) == 0) {
+        m_armed_time = arrive_time;
     }
 }
 
-void Timer::addTimerEvent(TimerEvent::s_ptr event) {
-    // 每次添加定时任务时，都会将定时任务插入到 pending_events 中
-    // !! 每次添加任务时，需要更新 timerfd 的唤醒时间，即将最近的到达时间设置为 timerfd 的唤醒时间
-    bool is_reset_timerfd = false;
+void Timer::resetWheelTimer() {
+    bool arm = m_wheel->size() > 0;
+    if (arm == m_wheel_armed) {
+        return;
+    }
+    struct itimerspec new_value;
+    memset(&new_value, 0, sizeof(new_value)); // stop timerfd
+    if (arm) {
+        int64_t tick_us = m_wheel->getTickUs();
+        new_value.it_interval.tv_sec = tick_us / 1000000;
+        new_value.it_interval.tv_nsec = (tick_us % 1000000) * 1000;
+        new_value.it_value = new_value.it_interval;
+    }
+    if (settime(0, &new_value) < 0) {
+        return;
+    }
+    m_wheel_armed = arm;
+}
 
-    {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        if (m_pending_events.empty()) {
-            is_reset_timerfd = true;
+void Timer::setTimingWheel(int64_t tick_ms) {
+    std::vector<TimerEvent::s_ptr> events;
+    if (tick_ms > 0) {
+        if (m_wheel && m_wheel->getTickUs() == tick_ms * 1000) {
+            return;
         }
-        else {
-            int64_t arrive_time = m_pending_events.begin()->first;
-            if (event->getArriveTime() < arrive_time) {
-                is_reset_timerfd = true;
-            }
+        if (m_wheel) {
+            m_wheel->takeAll(events);
+            delete m_wheel;
+        }
+        m_wheel = new TimingWheel(tick_ms * 1000, getMonotonicUs());
+        for (auto &item : m_pending_events) {
+            item.second->m_in_map = false;
+            events.push_back(item.second);
+        }
+        m_pending_events.clear();
+        for (auto &event : events) {
+            m_wheel->add(event);
+        }
+        m_wheel_armed = false;
+        m_armed_time = 0;
+        m_reset_pending = false;
+        resetWheelTimer();
+        INFOLOG("Timer use timing wheel, tick [%ld ms], migrated [%lu] timer events", tick_ms, events.size());
+        return;
+    }
+    if (!m_wheel) {
+        return;
+    }
+    m_wheel->takeAll(events);
+    delete m_wheel;
+    m_wheel = nullptr;
+    m_wheel_armed = false;
+    for (auto &event : events) {
+        event->m_map_pos = m_pending_events.emplace(event->getArriveTime(), event);
+        event->m_in_map = true;
+    }
+    // 关闭周期性的 timerfd, 改为最近的到达时间
+    struct itimerspec new_value;
+    memset(&new_value, 0, sizeof(new_value)); // stop timerfd
+    settime(0, &new_value);
+    m_armed_time = 0;
+    resetTimer();
+}
+
+void Timer::addTimerEvent(TimerEvent::s_ptr event) {
+    if (m_wheel) {
+        if (m_wheel->size() == 0) {
+            // 空闲时 timerfd 已经关闭，时间轮先跳到当前时间(与新任务的到达时间一样读取实时时钟)
+            std::vector<TimerEvent::s_ptr> expired;
+            m_wheel->advance(getMonotonicUs(), expired);
         }
+        m_wheel->add(event);
+        resetWheelTimer();
+        DEBUGLOG("add TimerEvent to timing wheel, arrive_time: %ld us", event->getArriveTime());
+        return;
+    }
 
-        int64_t arrive_time = event->getArriveTime();
-        // m_pending_events.insert({arrive_time, event});
-        m_pending_events.emplace(arrive_time, event);
+    // 每次添加定时任务时，都会将定时任务插入到 pending_events 中
+    // !! 每次添加任务时，需要更新 timerfd 的唤醒时间，即将最近的到达时间设置为 timerfd 的唤醒时间
+    if (event->m_in_map) {
+        // 已经添加过(如重复添加)，先删除原来的位置
+        m_pending_events.erase(event->m_map_pos);
+        event->m_in_map = false;
     }
+    int64_t arrive_time = event->getArriveTime();
+    bool is_reset_timerfd = m_pending_events.empty() || arrive_time < m_pending_events.begin()->first;
+
+    // m_pending_events.insert({arrive_time, event});
+    event->m_map_pos = m_pending_events.emplace(arrive_time, event);
+    event->m_in_map = true;
 
     if (is_reset_timerfd) {
-        resetTimer();
+        markReset();
     }
 
-    DEBUGLOG("add TimerEvent, arrive_time: %lld [%s]", event->getArriveTime(),
-             getFormatTime(event->getArriveTime()).c_str());
+    DEBUGLOG("add TimerEvent, arrive_time: %ld us", event->getArriveTime());
 }
 
 void Timer::deleteTimerEvent(TimerEvent::s_ptr event) {
-    // 删除定时任务
-    // TODO: cancel 这里一写一读，这里是否需要加锁
+    // 删除定时任务: 清空任务(立即释放回调函数捕获的变量)，并从定时任务集合中移除(释放 Timer 持有的引用)
     event->setCanceled(true);
 
-    bool is_reset_timerfd = false;
-    {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        auto range_events = m_pending_events.equal_range(event->getArriveTime());
-        for (auto it = range_events.first; it != range_events.second; ++it) {
-            if (it->second == event) { // 指向同一个对象
-                m_pending_events.erase(it);
-                // 如果删除的是最近的到达时间，需要更新 timerfd 的唤醒时间
-                if (m_pending_events.empty() || m_pending_events.begin()->first != event->getArriveTime()) {
-                    is_reset_timerfd = true;
-                }
-                break;
-            }
-        }
+    if (m_wheel) {
+        // O(1) 删除; 没有任务时下一个 tick 再关闭 timerfd
+        m_wheel->remove(event);
+        return;
     }
+
+    if (!event->m_in_map) {
+        // 已经到期取出或者没有添加
+        return;
+    }
+    // O(1) 删除(均摊), 使用添加时记录的迭代器
     // 如果删除的是最近的到达时间，需要更新 timerfd 的唤醒时间
+    bool is_reset_timerfd = event->m_map_pos == m_pending_events.begin();
+    m_pending_events.erase(event->m_map_pos);
+    event->m_in_map = false;
     if (is_reset_timerfd) {
-        resetTimer();
+        markReset();
     }
 
-    DEBUGLOG("delete TimerEvent, arrive_time: %lld [%s]", event->getArriveTime(),
-             getFormatTime(event->getArriveTime()).c_str());
+    DEBUGLOG("delete TimerEvent, arrive_time: %ld us", event->getArriveTime());
 }
 
 } // namespace rapidrpc
\ No newline at end of file
@@ -6,22 +6,37 @@
 
 namespace rapidrpc {
 
-TimerEvent::TimerEvent(int interval, bool is_repeat, std::function<void()> cb)
-    : m_interval(interval), m_is_repeat(is_repeat), m_task(cb) {
+TimerEvent::TimerEvent(int interval, bool is_repeat, Task cb)
+    : TimerEvent(std::chrono::milliseconds(interval), is_repeat, std::move(cb)) {}
 
-    // m_arrive_time = getNowMs() + m_interval;
-    resetArriveTime();
+TimerEvent::TimerEvent(std::chrono::microseconds interval, bool is_repeat, Task cb)
+    : m_interval(interval.count()), m_is_repeat(is_repeat), m_task(std::move(cb)) {
 
-    DEBUGLOG("create TimerEvent, arrive_time: %lld [%s], interval: %d, repeat:%s", m_arrive_time,
-             getFormatTime(m_arrive_time).c_str(), m_interval, m_is_repeat ? "true" : "false");
+    resetArriveTime(true);
+
+    DEBUGLOG("create TimerEvent, arrive_time: %ld us, interval: %ld us, repeat:%s", m_arrive_time, m_interval,
+             m_is_repeat ? "true" : "false");
 }
 
 TimerEvent::~TimerEvent() {}
 
-void TimerEvent::resetArriveTime() {
+void TimerEvent::runTask() {
+    if (!m_task) {
+        return;
+    }
+    Task task(std::move(m_task));
+    task();
+    // 重复任务没有被取消/重新设置时，恢复任务
+    if (m_is_repeat && !m_is_canceled && !m_task) {
+        m_task = std::move(task);
+    }
+}
+
+void TimerEvent::resetArriveTime(bool precise) {
     // m_arrive_time += m_interval;
-    // ! 使用 NowMs 纠正
-    m_arrive_time = getNowMs() + m_interval;
+    // ! 使用当前时间纠正; 单调时钟, 系统时间(NTP)调整时定时任务不会提前/推迟
+    // 重复任务在 onTimer 中使用本轮循环缓存的时间(等待事件返回时读取, 与到期判断使用同一个时间)
+    m_arrive_time = (precise ? getMonotonicUs() : getCachedMonotonicUs()) + m_interval;
 }
 
 } // namespace rapidrpc
\ No newline at end of file
@@ -0,0 +1,126 @@
+#include "rapidrpc/net/timing_wheel.h"
+
+namespace rapidrpc {
+
+TimingWheel::TimingWheel(int64_t tick_us, int64_t now_us) : m_tick_us(tick_us > 0 ? tick_us : 1), m_start_us(now_us) {}
+
+// 向上取整，保证定时任务不会提前执行
+int64_t TimingWheel::toTick(int64_t time_us) const {
+    int64_t delta = time_us - m_start_us;
+    if (delta <= 0) {
+        return 0;
+    }
+    return (delta + m_tick_us - 1) / m_tick_us;
+}
+
+TimingWheel::Slot *TimingWheel::findSlot(int64_t expire_tick) {
+    int64_t ticks = expire_tick - m_current_tick;
+    if (ticks < 0) {
+        // 已经到期，下一个处理的 tick 执行
+        return &m_root[m_current_tick & (ROOT_SIZE - 1)];
+    }
+    if (ticks < ROOT_SIZE) {
+        return &m_root[expire_tick & (ROOT_SIZE - 1)];
+    }
+    for (int level = 0; level < LEVELS - 1; level++) {
+        int shift = ROOT_BITS + level * LEVEL_BITS;
+        if (ticks < (1LL << (shift + LEVEL_BITS))) {
+            return &m_levels[level][(expire_tick >> shift) & (LEVEL_SIZE - 1)];
+        }
+    }
+    // 超出范围，放在最高层最远的槽，转到时重新放置
+    int shift = ROOT_BITS + (LEVELS - 2) * LEVEL_BITS;
+    return &m_levels[LEVELS - 2][((m_current_tick + MAX_TICKS) >> shift) & (LEVEL_SIZE - 1)];
+}
+
+void TimingWheel::place(Slot *from, Slot::iterator pos) {
+    TimerEvent *event = pos->get();
+    Slot *to = findSlot(event->m_wheel_tick);
+    // splice 后迭代器仍然有效，指向新链表中的节点
+    to->splice(to->end(), *from, pos);
+    event->m_wheel_slot = to;
+    event->m_wheel_pos = pos;
+}
+
+int TimingWheel::cascade(int level, int index) {
+    Slot slot;
+    slot.splice(slot.end(), m_levels[level][index]);
+    while (!slot.empty()) {
+        place(&slot, slot.begin());
+    }
+    return index;
+}
+
+void TimingWheel::add(TimerEvent::s_ptr event) {
+    if (event->m_wheel_slot) {
+        remove(event);
+    }
+    event->m_wheel_tick = toTick(event->getArriveTime());
+    Slot *slot = findSlot(event->m_wheel_tick);
+    slot->push_back(event);
+    event->m_wheel_slot = slot;
+    event->m_wheel_pos = std::prev(slot->end());
+    m_size++;
+}
+
+bool TimingWheel::remove(const TimerEvent::s_ptr &event) {
+    if (!event->m_wheel_slot) {
+        return false;
+    }
+    Slot *slot = event->m_wheel_slot;
+    event->m_wheel_slot = nullptr;
+    slot->erase(event->m_wheel_pos);
+    m_size--;
+    return true;
+}
+
+void TimingWheel::advance(int64_t now_us, std::vector<TimerEvent::s_ptr> &expired) {
+    int64_t now_tick = now_us >= m_start_us ? (now_us - m_start_us) / m_tick_us : -1;
+    while (m_current_tick <= now_tick) {
+        if (m_size == 0) {
+            // 没有任务，直接跳到当前时间
+            m_current_tick = now_tick + 1;
+            break;
+        }
+        int index = m_current_tick & (ROOT_SIZE - 1);
+        // 第 0 层转完一圈，上一层当前槽的任务放到下层；上一层也转完一圈时继续向上
+        if (index == 0) {
+            for (int level = 0; level < LEVELS - 1; level++) {
+                int shift = ROOT_BITS + level * LEVEL_BITS;
+                if (cascade(level, (m_current_tick >> shift) & (LEVEL_SIZE - 1)) != 0) {
+                    break;
+                }
+            }
+        }
+        m_current_tick++;
+
+        Slot &slot = m_root[index];
+        for (auto &event : slot) {
+            event->m_wheel_slot = nullptr;
+            expired.push_back(std::move(event));
+        }
+        m_size -= slot.size();
+        slot.clear();
+    }
+}
+
+void TimingWheel::takeAll(std::vector<TimerEvent::s_ptr> &events) {
+    auto take = [&events](Slot &slot) {
+        for (auto &event : slot) {
+            event->m_wheel_slot = nullptr;
+            events.push_back(std::move(event));
+        }
+        slot.clear();
+    };
+    for (int i = 0; i < ROOT_SIZE; i++) {
+        take(m_root[i]);
+    }
+    for (int level = 0; level < LEVELS - 1; level++) {
+        for (int i = 0; i < LEVEL_SIZE; i++) {
+            take(m_levels[level][i]);
+        }
+    }
+    m_size = 0;
+}
+
+} // namespace rapidrpc
@@ -21,17 +21,15 @@ void WakeupFdEvent::init() {
     m_read_callback = [this]() {
         // read wakeup_fd to clear
         char buf[8];
-        ssize_t rt = 0;
-        // read and clear counter
-        while ((rt = read(m_fd, buf, sizeof(buf))) == -1 && errno == EAGAIN)
-            ;
-        if (rt < 0) { // error： EINVAL, never happen
+        // read and clear counter, 只在 wakeup fd 可读时调用，读取一次即可
+        ssize_t rt = read(m_fd, buf, sizeof(buf));
+        if (rt < 0 && errno != EAGAIN) { // error： EINVAL, never happen
             ERRORLOG("WakeupFdEvent read callback failed, read less than 8 bytes");
         }
         // 每次跨线程添加 fd， 唤醒后，会回调本函数清空 wakeup_fd
         DEBUGLOG("WakeupFdEvent read callback finished, read full %ld bytes", rt);
     };
-    m_listen_events.data.ptr = this;
+    // epoll data 由 getEpollEvent 设置
 }
 
 // wakeup_fd is nonblocking - EAGAIN
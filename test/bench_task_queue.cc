@@ -0,0 +1,122 @@
+/**
+ * EventLoop 任务队列的基准测试: 1..N 个生产者线程并发添加任务，一个消费者线程批量取出执行
+ * 对比 MpscQueue(无锁) 与 mutex + std::queue(原 EventLoop::addTask 的实现)
+ * usage: ./bench_task_queue [max_producers] [tasks_per_producer]
+ */
+
+#include "rapidrpc/common/mpsc_queue.h"
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+
+struct Task: public rapidrpc::MpscQueue::Node {
+    explicit Task(std::function<void()> &&cb) : m_cb(std::move(cb)) {}
+    std::function<void()> m_cb;
+};
+
+// 原来的实现: 生产者加锁 push, 消费者加锁 swap 整个队列
+class MutexTaskQueue {
+public:
+    void push(std::function<void()> cb) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tasks.push(std::move(cb));
+    }
+    int drain() {
+        std::queue<std::function<void()>> tasks;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            tasks.swap(m_tasks);
+        }
+        int n = 0;
+        while (!tasks.empty()) {
+            tasks.front()();
+            tasks.pop();
+            n++;
+        }
+        return n;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::queue<std::function<void()>> m_tasks;
+};
+
+class LockFreeTaskQueue {
+public:
+    void push(std::function<void()> cb) {
+        m_tasks.push(new Task(std::move(cb)));
+    }
+    int drain() {
+        int n = 0;
+        rapidrpc::MpscQueue::Node *node = nullptr;
+        while ((node = m_tasks.pop()) != nullptr) {
+            Task *task = static_cast<Task *>(node);
+            task->m_cb();
+            delete task;
+            n++;
+        }
+        return n;
+    }
+
+private:
+    rapidrpc::MpscQueue m_tasks;
+};
+
+// return producer throughput, million tasks per second
+template <typename Queue>
+double run(int producers, int tasks_per_producer) {
+    Queue queue;
+    std::atomic<bool> start{false};
+    long long sum = 0; // only touched by consumer
+    long long total = static_cast<long long>(producers) * tasks_per_producer;
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; p++) {
+        threads.emplace_back([&queue, &start, &sum, tasks_per_producer]() {
+            while (!start.load(std::memory_order_acquire))
+                ;
+            for (int i = 0; i < tasks_per_producer; i++) {
+                queue.push([&sum]() {
+                    sum++;
+                });
+            }
+        });
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    start.store(true, std::memory_order_release);
+    long long done = 0;
+    while (done < total) {
+        done += queue.drain();
+    }
+    auto end = std::chrono::steady_clock::now();
+    for (auto &t : threads) {
+        t.join();
+    }
+    if (sum != total) {
+        printf("ERROR: executed %lld tasks, expect %lld\n", sum, total);
+        exit(-1);
+    }
+    double sec = std::chrono::duration<double>(end - begin).count();
+    return total / sec / 1e6;
+}
+
+int main(int argc, char *argv[]) {
+    int max_producers = argc > 1 ? atoi(argv[1]) : std::max(4u, std::thread::hardware_concurrency());
+    int tasks_per_producer = argc > 2 ? atoi(argv[2]) : 1000000;
+
+    printf("%-10s %-18s %-18s %-8s\n", "producers", "mutex(Mops/s)", "mpsc(Mops/s)", "speedup");
+    for (int p = 1; p <= max_producers; p++) {
+        double mutex_ops = run<MutexTaskQueue>(p, tasks_per_producer);
+        double mpsc_ops = run<LockFreeTaskQueue>(p, tasks_per_producer);
+        printf("%-10d %-18.2f %-18.2f %-8.2f\n", p, mutex_ops, mpsc_ops, mpsc_ops / mutex_ops);
+    }
+    return 0;
+}
@@ -0,0 +1,145 @@
+/**
+ * 定时器存储结构的基准测试: N 个未到期的定时任务(模拟 RPC 超时)，统计添加、取消一半、全部到期的平均耗时
+ * 对比 std::multimap(原 Timer 的实现) 与分层时间轮 TimingWheel
+ * usage: ./bench_timer [timers] [max_timeout_ms]
+ */
+
+#include "rapidrpc/net/timing_wheel.h"
+#include "rapidrpc/net/timer_event.h"
+#include "rapidrpc/common/config.h"
+#include "rapidrpc/common/log.h"
+
+#include <chrono>
+#include <map>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+
+using Clock = std::chrono::steady_clock;
+
+struct Result {
+    double insert_ns;
+    double cancel_ns;
+    double expire_ns;
+};
+
+static double nsPerOp(Clock::time_point begin, Clock::time_point end, size_t ops) {
+    return std::chrono::duration<double, std::nano>(end - begin).count() / (ops ? ops : 1);
+}
+
+// 与 Timer 相同: emplace 添加, equal_range 查找后删除, 到期时取出 [begin, now] 中未取消的任务
+Result runMultimap(const std::vector<rapidrpc::TimerEvent::s_ptr> &events, int64_t start, int64_t end) {
+    Result result;
+    std::multimap<int64_t, rapidrpc::TimerEvent::s_ptr> pending;
+
+    auto begin = Clock::now();
+    for (auto &event : events) {
+        pending.emplace(event->getArriveTime(), event);
+    }
+    result.insert_ns = nsPerOp(begin, Clock::now(), events.size());
+
+    begin = Clock::now();
+    for (size_t i = 0; i < events.size(); i += 2) {
+        auto range = pending.equal_range(events[i]->getArriveTime());
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second == events[i]) {
+                pending.erase(it);
+                break;
+            }
+        }
+    }
+    result.cancel_ns = nsPerOp(begin, Clock::now(), events.size() / 2);
+
+    size_t expired_count = 0;
+    std::vector<rapidrpc::TimerEvent::s_ptr> expired;
+    begin = Clock::now();
+    for (int64_t now = start; now < end + 1000; now += 1000) {
+        expired.clear();
+        auto it = pending.begin();
+        while (it != pending.end() && it->first <= now) {
+            if (!it->second->isCanceled()) {
+                expired.push_back(it->second);
+            }
+            ++it;
+        }
+        pending.erase(pending.begin(), it);
+        expired_count += expired.size();
+    }
+    result.expire_ns = nsPerOp(begin, Clock::now(), expired_count);
+    if (expired_count != events.size() - (events.size() + 1) / 2) {
+        printf("ERROR: multimap expired %lu timers\n", expired_count);
+        exit(-1);
+    }
+    return result;
+}
+
+Result runTimingWheel(const std::vector<rapidrpc::TimerEvent::s_ptr> &events, int64_t start, int64_t end) {
+    Result result;
+    rapidrpc::TimingWheel wheel(1000, start);
+
+    auto begin = Clock::now();
+    for (auto &event : events) {
+        wheel.add(event);
+    }
+    result.insert_ns = nsPerOp(begin, Clock::now(), events.size());
+
+    begin = Clock::now();
+    for (size_t i = 0; i < events.size(); i += 2) {
+        wheel.remove(events[i]);
+    }
+    result.cancel_ns = nsPerOp(begin, Clock::now(), events.size() / 2);
+
+    size_t expired_count = 0;
+    std::vector<rapidrpc::TimerEvent::s_ptr> expired;
+    begin = Clock::now();
+    for (int64_t now = start; now < end + 1000; now += 1000) {
+        expired.clear();
+        wheel.advance(now, expired);
+        expired_count += expired.size();
+    }
+    result.expire_ns = nsPerOp(begin, Clock::now(), expired_count);
+    if (expired_count != events.size() - (events.size() + 1) / 2) {
+        printf("ERROR: timing wheel expired %lu timers\n", expired_count);
+        exit(-1);
+    }
+    return result;
+}
+
+int main(int argc, char *argv[]) {
+    int timers = argc > 1 ? atoi(argv[1]) : 1000000;
+    int max_timeout = argc > 2 ? atoi(argv[2]) : 60000;
+
+    rapidrpc::Config::SetGlobalConfig(nullptr);
+    rapidrpc::Config::GetGlobalConfig()->m_log_level = "ERROR";
+    rapidrpc::Logger::InitGlobalLogger();
+
+    // 预先创建定时任务, 到达时间在 [now, now + max_timeout) 内随机分布
+    srandom(12345);
+    std::vector<rapidrpc::TimerEvent::s_ptr> events;
+    events.reserve(timers);
+    for (int i = 0; i < timers; i++) {
+        events.push_back(std::make_shared<rapidrpc::TimerEvent>(random() % max_timeout, false, nullptr));
+    }
+    int64_t start = events.front()->getArriveTime();
+    int64_t end = start;
+    for (auto &event : events) {
+        start = std::min(start, event->getArriveTime());
+        end = std::max(end, event->getArriveTime());
+    }
+    start -= static_cast<int64_t>(max_timeout) * 1000; // 模拟添加时的时间
+
+    Result map_result = runMultimap(events, start, end);
+    Result wheel_result = runTimingWheel(events, start, end);
+
+    printf("timers [%d], timeout [0, %dms), 1ms per step\n", timers, max_timeout);
+    printf("%-10s %-16s %-16s %-8s\n", "op", "multimap(ns/op)", "wheel(ns/op)", "speedup");
+    printf("%-10s %-16.1f %-16.1f %-8.2f\n", "insert", map_result.insert_ns, wheel_result.insert_ns,
+           map_result.insert_ns / wheel_result.insert_ns);
+    printf("%-10s %-16.1f %-16.1f %-8.2f\n", "cancel", map_result.cancel_ns, wheel_result.cancel_ns,
+           map_result.cancel_ns / wheel_result.cancel_ns);
+    printf("%-10s %-16.1f %-16.1f %-8.2f\n", "expire", map_result.expire_ns, wheel_result.expire_ns,
+           map_result.expire_ns / wheel_result.expire_ns);
+
+    rapidrpc::Logger::GetGlobalLogger()->flushAndStop();
+    return 0;
+}
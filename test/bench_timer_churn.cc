@@ -0,0 +1,100 @@
+/**
+ * 定时任务频繁添加/删除(如每个 RPC 调用设置超时，收到响应后取消)的基准测试: 1..N 个 IO 线程，
+ * 每个 IO 线程在自己的 EventLoop 中添加并删除定时任务，统计每个 IO 线程的吞吐
+ * 对比每次操作外加一把不竞争的锁与 EventLoop 线程内不加锁, 结果只是加锁开销的估计(lock overhead estimate),
+ * 不是原 Timer 实现(Timer::m_mutex)的实测数据: 外加的锁只模拟了加锁本身, 没有多线程竞争
+ * usage: ./bench_timer_churn [max_io_threads] [ops_per_thread]
+ */
+
+#include "rapidrpc/net/io_thread_group.h"
+#include "rapidrpc/net/timer_event.h"
+#include "rapidrpc/common/config.h"
+#include "rapidrpc/common/log.h"
+#include "rapidrpc/common/util.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+
+// return throughput per io thread, million add+delete pairs per second
+double run(int io_threads, int ops, bool locked) {
+    rapidrpc::IOThreadGroup group(io_threads);
+    group.start();
+
+    std::vector<std::unique_ptr<std::mutex>> mutexes;
+    std::atomic<int> done{0};
+    std::atomic<int64_t> total_us{0};
+    for (int t = 0; t < io_threads; t++) {
+        rapidrpc::EventLoop *loop = group.getIOThread()->getEventLoop();
+        mutexes.emplace_back(new std::mutex());
+        std::mutex *mutex = mutexes.back().get();
+        loop->addTask(
+            [loop, mutex, ops, locked, &done, &total_us]() {
+                // 已有的 1000 个未到期的定时任务, 添加的超时时间在它们之后，不需要重新设置 timerfd
+                std::vector<rapidrpc::TimerEvent::s_ptr> inflight;
+                for (int i = 0; i < 1000; i++) {
+                    inflight.push_back(std::make_shared<rapidrpc::TimerEvent>(1000 + i, false, nullptr));
+                    loop->addTimerEvent(inflight.back());
+                }
+                int64_t start = rapidrpc::getMonotonicUs();
+                for (int i = 0; i < ops; i++) {
+                    auto event = std::make_shared<rapidrpc::TimerEvent>(3000, false, nullptr);
+                    if (locked) {
+                        std::lock_guard<std::mutex> lock(*mutex);
+                        loop->addTimerEvent(event);
+                    }
+                    else {
+                        loop->addTimerEvent(event);
+                    }
+                    if (locked) {
+                        std::lock_guard<std::mutex> lock(*mutex);
+                        loop->deleteTimerEvent(event);
+                    }
+                    else {
+                        loop->deleteTimerEvent(event);
+                    }
+                }
+                total_us += rapidrpc::getMonotonicUs() - start;
+                for (auto &event : inflight) {
+                    loop->deleteTimerEvent(event);
+                }
+                done++;
+            },
+            true);
+    }
+    while (done < io_threads) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    for (int t = 0; t < io_threads; t++) {
+        group.getIOThread()->getEventLoop()->stop();
+    }
+    group.join();
+
+    double avg_sec = total_us.load() / 1e6 / io_threads;
+    return ops / avg_sec / 1e6;
+}
+
+int main(int argc, char *argv[]) {
+    int max_io_threads = argc > 1 ? atoi(argv[1]) : std::max(4u, std::thread::hardware_concurrency());
+    int ops = argc > 2 ? atoi(argv[2]) : 1000000;
+
+    rapidrpc::Config::SetGlobalConfig(nullptr);
+    rapidrpc::Config::GetGlobalConfig()->m_log_level = "ERROR";
+    rapidrpc::Logger::InitGlobalLogger();
+
+    printf("lock overhead estimate: loop path with and without an extra uncontended mutex per op\n");
+    printf("%-12s %-22s %-22s %-8s\n", "io threads", "+mutex(Mops/s/thread)", "loop(Mops/s/thread)", "overhead");
+    for (int t = 1; t <= max_io_threads; t *= 2) {
+        double locked_ops = run(t, ops, true);
+        double loop_ops = run(t, ops, false);
+        printf("%-12d %-22.2f %-22.2f %-8.2f\n", t, locked_ops, loop_ops, loop_ops / locked_ops);
+    }
+
+    rapidrpc::Logger::GetGlobalLogger()->flushAndStop();
+    return 0;
+}
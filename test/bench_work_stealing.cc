@@ -0,0 +1,109 @@
+/**
+ * 业务线程池的基准测试: 4 个提交线程(模拟 IO 线程)提交短任务和少量长任务(CPU 密集)，
+ * 对比共享队列(WorkerPool) 与工作窃取(WorkStealingPool) 在 4..N 个业务线程时的吞吐和 p99 延迟(提交到执行完)
+ * 每个提交线程最多有 window 个未完成的任务(模拟连接上未返回的请求)
+ * usage: ./bench_work_stealing [max_threads] [tasks] [long_percent] [short_us] [long_us]
+ */
+
+#include "rapidrpc/common/log.h"
+#include "rapidrpc/common/config.h"
+#include "rapidrpc/common/worker_pool.h"
+#include "rapidrpc/common/work_stealing_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+
+using Clock = std::chrono::steady_clock;
+
+static const int g_producers = 4;
+static const int g_window = 128;
+
+static void spin(int us) {
+    auto end = Clock::now() + std::chrono::microseconds(us);
+    while (Clock::now() < end)
+        ;
+}
+
+struct Result {
+    double m_kops{0}; // 千次/秒
+    double m_p99_us{0};
+};
+
+template <typename Pool>
+Result run(int threads, int tasks, int long_percent, int short_us, int long_us) {
+    Pool pool(threads, 0);
+    std::vector<int64_t> latency_ns(tasks);
+    std::atomic<int> outstanding[g_producers];
+    for (auto &o : outstanding) {
+        o = 0;
+    }
+
+    auto begin = Clock::now();
+    std::vector<std::thread> producers;
+    for (int p = 0; p < g_producers; p++) {
+        producers.emplace_back([&, p]() {
+            uint64_t seed = 0x9E3779B97F4A7C15ULL * (p + 1);
+            for (int i = p; i < tasks; i += g_producers) {
+                while (outstanding[p].load(std::memory_order_acquire) >= g_window) {
+                    std::this_thread::yield();
+                }
+                seed ^= seed << 13;
+                seed ^= seed >> 7;
+                seed ^= seed << 17;
+                int cost = static_cast<int>(seed % 100) < long_percent ? long_us : short_us;
+                outstanding[p]++;
+                auto submit_time = Clock::now();
+                std::atomic<int> *counter = &outstanding[p];
+                int64_t *slot = &latency_ns[i];
+                while (!pool.submit([cost, submit_time, counter, slot]() {
+                    spin(cost);
+                    *slot = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - submit_time).count();
+                    counter->fetch_sub(1, std::memory_order_release);
+                })) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto &t : producers) {
+        t.join();
+    }
+    pool.stop();
+    auto end = Clock::now();
+
+    Result result;
+    result.m_kops = tasks / std::chrono::duration<double>(end - begin).count() / 1e3;
+    size_t index = static_cast<size_t>(tasks * 0.99);
+    std::nth_element(latency_ns.begin(), latency_ns.begin() + index, latency_ns.end());
+    result.m_p99_us = latency_ns[index] / 1e3;
+    return result;
+}
+
+int main(int argc, char *argv[]) {
+    int max_threads = argc > 1 ? atoi(argv[1]) : 64;
+    int tasks = argc > 2 ? atoi(argv[2]) : 200000;
+    int long_percent = argc > 3 ? atoi(argv[3]) : 2;
+    int short_us = argc > 4 ? atoi(argv[4]) : 2;
+    int long_us = argc > 5 ? atoi(argv[5]) : 200;
+
+    rapidrpc::Config::SetGlobalConfig(nullptr);
+    rapidrpc::Config::GetGlobalConfig()->m_log_level = "ERROR";
+    rapidrpc::Logger::InitGlobalLogger();
+
+    printf("tasks [%d], long tasks [%d%%], short [%dus], long [%dus], producers [%d], cpus [%u]\n", tasks,
+           long_percent, short_us, long_us, g_producers, std::thread::hardware_concurrency());
+    printf("%-8s %-14s %-14s %-14s %-14s\n", "threads", "queue(Kops/s)", "queue p99(us)", "ws(Kops/s)", "ws p99(us)");
+    for (int threads = 4; threads <= max_threads; threads *= 2) {
+        Result queue = run<rapidrpc::WorkerPool>(threads, tasks, long_percent, short_us, long_us);
+        Result ws = run<rapidrpc::WorkStealingPool>(threads, tasks, long_percent, short_us, long_us);
+        printf("%-8d %-14.1f %-14.1f %-14.1f %-14.1f\n", threads, queue.m_kops, queue.m_p99_us, ws.m_kops,
+               ws.m_p99_us);
+    }
+    return 0;
+}
@@ -0,0 +1,111 @@
+/**
+ * 测试批量 accept:
+ * 1. TcpAcceptor::accept 使用 accept4, 新 fd 按 flags 设置非阻塞和 close-on-exec; 非阻塞监听 fd 没有连接时返回 -1
+ * 2. 大量客户端同时连接(backlog 中堆积的连接)，服务端分批 accept 并分配给 IO 线程，每个连接都可以正常请求,
+ *    预先计入的 IO 线程连接数在创建连接后没有重复计算
+ */
+
+#include "rapidrpc/common/log.h"
+#include "rapidrpc/common/config.h"
+#include "rapidrpc/net/tcp/net_addr.h"
+#include "rapidrpc/net/tcp/tcp_acceptor.h"
+#include "rapidrpc/net/tcp/tcp_server.h"
+#include "rapidrpc/net/rpc/dispatcher.h"
+#include "order.pb.h"
+#include "test_util.h"
+
+#include <google/protobuf/service.h>
+#include <sys/socket.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <stdio.h>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+class OrderImpl: public Order {
+public:
+    void makeOrder(google::protobuf::RpcController *controller, const ::makeOrderRequest *request,
+                   ::makeOrderResponse *response, google::protobuf::Closure *done) {
+        response->set_ret_code(0);
+        response->set_order_id(std::to_string(request->price()));
+    }
+};
+
+void test_acceptor_flags() {
+    rapidrpc::TcpAcceptor acceptor(std::make_shared<rapidrpc::IpNetAddr>("127.0.0.1:12352"), 64);
+    int client1 = connect_server(12352);
+    int client2 = connect_server(12352);
+
+    rapidrpc::IpNetAddr addr;
+    int fd1 = acceptor.accept(addr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    CHECK(fd1 >= 0);
+    CHECK(fcntl(fd1, F_GETFL) & O_NONBLOCK);
+    CHECK(fcntl(fd1, F_GETFD) & FD_CLOEXEC);
+    CHECK(addr.toString().compare(0, 10, "127.0.0.1:") == 0);
+
+    // 默认阻塞, close-on-exec
+    int fd2 = acceptor.accept(addr);
+    CHECK(fd2 >= 0);
+    CHECK(!(fcntl(fd2, F_GETFL) & O_NONBLOCK));
+    CHECK(fcntl(fd2, F_GETFD) & FD_CLOEXEC);
+
+    // 非阻塞监听 fd, backlog 为空
+    int listen_fd = acceptor.getListenFd();
+    CHECK(fcntl(listen_fd, F_SETFL, fcntl(listen_fd, F_GETFL) | O_NONBLOCK) == 0);
+    CHECK(acceptor.accept(addr, SOCK_NONBLOCK | SOCK_CLOEXEC) == -1);
+    CHECK(errno == EAGAIN || errno == EWOULDBLOCK);
+
+    close(fd1);
+    close(fd2);
+    close(client1);
+    close(client2);
+    close(listen_fd);
+    printf("test_acceptor_flags success\n");
+}
+
+void test_connection_storm(int connections) {
+    rapidrpc::TcpServer *server = nullptr;
+    std::thread thread([&server]() {
+        server = new rapidrpc::TcpServer(std::make_shared<rapidrpc::IpNetAddr>("127.0.0.1:12353"));
+        server->start();
+    });
+    thread.detach();
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    // connect 在三次握手完成后返回, 服务端还没有 accept 的连接堆积在 backlog 中
+    std::vector<int> fds;
+    for (int i = 0; i < connections; i++) {
+        fds.push_back(connect_server(12353));
+    }
+    for (int i = 0; i < connections; i++) {
+        call(fds[i], i);
+    }
+
+    // round_robin 平均分配; 预先计入的连接数在 IO 线程创建连接时已经减去
+    rapidrpc::IOThreadGroup *group = server->getIOThreadGroup();
+    for (int i = 0; i < group->getSize(); i++) {
+        CHECK(group->getIOThread(i)->getEventLoop()->getConnectionCount() == connections / group->getSize());
+    }
+    for (int fd : fds) {
+        close(fd);
+    }
+    printf("test_connection_storm success, connections [%d]\n", connections);
+}
+
+int main() {
+    rapidrpc::Config::SetGlobalConfig(nullptr);
+    rapidrpc::Config::GetGlobalConfig()->m_log_level = "ERROR";
+    rapidrpc::Config::GetGlobalConfig()->m_io_threads = 4;
+    rapidrpc::Config::GetGlobalConfig()->m_accept_batch = 16;
+    rapidrpc::Config::GetGlobalConfig()->m_listen_backlog = 1024;
+    rapidrpc::Logger::InitGlobalLogger();
+    rapidrpc::Dispatcher::GetDispatcher()->registerService(std::make_shared<OrderImpl>());
+
+    test_acceptor_flags();
+    test_connection_storm(200);
+    return 0;
+}
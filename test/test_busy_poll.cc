@@ -0,0 +1,80 @@
+/**
+ * 测试 EventLoop 自适应自旋(busy poll): 空闲时每轮自旋没有等到事件，自旋时间减半，
+ * 直到直接阻塞等待; 阻塞后空闲的 IO 线程不再消耗 CPU
+ */
+
+#include "rapidrpc/net/eventloop.h"
+#include "rapidrpc/common/log.h"
+#include "rapidrpc/common/config.h"
+#include "test_util.h"
+
+#include <pthread.h>
+#include <time.h>
+#include <stdio.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+// 线程已经消耗的 CPU 时间(us)
+int64_t thread_cpu_us(std::thread &thread) {
+    clockid_t clock_id;
+    CHECK(pthread_getcpuclockid(thread.native_handle(), &clock_id) == 0);
+    timespec ts;
+    CHECK(clock_gettime(clock_id, &ts) == 0);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+}
+
+int main() {
+    rapidrpc::Config::SetGlobalConfig(nullptr);
+    rapidrpc::Config::GetGlobalConfig()->m_log_level = "ERROR";
+    rapidrpc::Logger::InitGlobalLogger();
+
+    const int64_t max_spin_us = 2000;
+    std::atomic<rapidrpc::EventLoop *> loop{nullptr};
+    std::thread thread([&loop, max_spin_us]() {
+        rapidrpc::EventLoop *current = rapidrpc::EventLoop::GetCurrentEventLoop();
+        current->setBusyPoll(max_spin_us);
+        loop = current;
+        current->loop();
+        delete current;
+    });
+    while (!loop) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    // 每次唤醒后执行任务，再自旋一轮(没有事件)，自旋时间减半
+    std::vector<int64_t> spins;
+    for (int i = 0; i < 20; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        std::atomic<int64_t> spin_us{-1};
+        loop.load()->addTask([&loop, &spin_us]() { spin_us = loop.load()->getBusyPollUs(); }, true);
+        while (spin_us < 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        spins.push_back(spin_us);
+        if (spin_us == 0) {
+            break;
+        }
+    }
+    for (size_t i = 0; i < spins.size(); i++) {
+        printf("wakeup [%lu], spin us [%ld]\n", i, spins[i]);
+        CHECK(spins[i] < max_spin_us);
+        if (i > 0) {
+            CHECK(spins[i] < spins[i - 1]);
+        }
+    }
+    CHECK(spins.back() == 0);
+
+    // 已经退出自旋: 空闲 200ms 只消耗很少的 CPU
+    int64_t cpu_start = thread_cpu_us(thread);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    int64_t cpu_us = thread_cpu_us(thread) - cpu_start;
+    printf("idle 200ms, io thread cpu [%ldus]\n", cpu_us);
+    CHECK(cpu_us < 20000);
+
+    loop.load()->stop();
+    thread.join();
+    printf("test_busy_poll_idle_exit success\n");
+    return 0;
+}
@@ -0,0 +1,96 @@
+/**
+ * 测试 EventLoop 每轮循环的任务预算: 超出预算的任务留到下一轮，
+ * 就绪的 IO 事件不需要等待任务队列全部执行完
+ */
+
+#include "rapidrpc/net/eventloop.h"
+#include "rapidrpc/net/fd_event.h"
+#include "rapidrpc/common/log.h"
+#include "rapidrpc/common/config.h"
+#include "test_util.h"
+
+#include <unistd.h>
+#include <stdio.h>
+#include <thread>
+#include <chrono>
+#include <vector>
+
+/**
+ * 添加 task_count 个任务和一个已经可读的 fd, 返回 fd 回调执行时已经执行的任务数
+ * @param task_us: 每个任务的执行时间
+ */
+int run_with_budget(int max_tasks, int64_t max_us, int task_count, int task_us) {
+    int io_seen_tasks = -1;
+    std::thread thread([&]() {
+        rapidrpc::EventLoop *loop = rapidrpc::EventLoop::GetCurrentEventLoop();
+        loop->setTaskBudget(max_tasks, max_us);
+
+        int fds[2];
+        CHECK(pipe(fds) == 0);
+        CHECK(write(fds[1], "x", 1) == 1);
+
+        int executed = 0;
+        std::vector<int> order;
+        rapidrpc::FdEvent event(fds[0]);
+        event.listen(rapidrpc::TriggerEvent::IN_EVENT, [&]() {
+            char c;
+            CHECK(read(fds[0], &c, 1) == 1);
+            io_seen_tasks = executed;
+        });
+        loop->addEpollEvent(&event);
+
+        for (int i = 0; i < task_count; i++) {
+            loop->addTask([&, i]() {
+                order.push_back(i);
+                executed++;
+                if (task_us > 0) {
+                    std::this_thread::sleep_for(std::chrono::microseconds(task_us));
+                }
+                if (executed == task_count) {
+                    loop->stop();
+                }
+            });
+        }
+        loop->loop();
+
+        // 剩余的任务按添加顺序执行
+        CHECK(static_cast<int>(order.size()) == task_count);
+        for (int i = 0; i < task_count; i++) {
+            CHECK(order[i] == i);
+        }
+        if (max_tasks > 0 || max_us > 0) {
+            CHECK(loop->getStats().m_tasks_deferred > 0);
+        }
+
+        loop->deleteEpollEvent(&event);
+        close(fds[0]);
+        close(fds[1]);
+        delete loop;
+    });
+    thread.join();
+    return io_seen_tasks;
+}
+
+int main() {
+    rapidrpc::Config::SetGlobalConfig(nullptr);
+    rapidrpc::Config::GetGlobalConfig()->m_log_level = "ERROR";
+    rapidrpc::Logger::InitGlobalLogger();
+
+    // 不限制: 全部任务执行完才处理 IO 事件
+    int seen = run_with_budget(0, 0, 1000, 0);
+    CHECK(seen == 1000);
+
+    // 每轮最多 10 个任务
+    seen = run_with_budget(10, 0, 1000, 0);
+    printf("max tasks [10], io event handled after [%d] tasks\n", seen);
+    CHECK(seen == 10);
+
+    // 每轮最多 500us, 每个任务 100us
+    seen = run_with_budget(0, 500, 100, 100);
+    printf("max time [500us], io event handled after [%d] tasks\n", seen);
+    CHECK(seen >= 1 && seen <= 5);
+
+    printf("test_eventloop_budget success\n");
+    rapidrpc::Logger::GetGlobalLogger()->flushAndStop();
+    return 0;
+}
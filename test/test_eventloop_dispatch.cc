@@ -0,0 +1,86 @@
+/**
+ * 测试 EventLoop 就绪事件的分发:
+ * 1. 直接分发: 回调在 epoll_wait 返回后由本线程直接执行，不经过任务队列
+ * 2. 直接分发: 同一批就绪事件中，前面的回调取消监听的 fd 不再执行回调
+ * 3. 任务队列分发(setDirectDispatch(false)): 回调添加到任务队列，下一轮执行
+ */
+
+#include "rapidrpc/net/eventloop.h"
+#include "rapidrpc/net/fd_event.h"
+#include "rapidrpc/common/log.h"
+#include "rapidrpc/common/config.h"
+#include "test_util.h"
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <thread>
+
+struct DispatchResult {
+    int m_calls{0};          // 两个 fd 的回调执行次数之和
+    bool m_in_loop{false};   // 回调是否在 EventLoop 线程中执行
+    uint64_t m_max_queue{0}; // 每轮待执行任务数的最大值
+};
+
+/**
+ * 两个已经可读的 eventfd 在同一批事件中返回, 每个回调都取消另一个 fd 的监听
+ */
+DispatchResult run_dispatch(bool direct) {
+    DispatchResult result;
+    std::thread thread([&]() {
+        rapidrpc::EventLoop *loop = rapidrpc::EventLoop::GetCurrentEventLoop();
+        loop->setDirectDispatch(direct);
+
+        int fd_a = eventfd(1, EFD_NONBLOCK);
+        int fd_b = eventfd(1, EFD_NONBLOCK);
+        CHECK(fd_a >= 0 && fd_b >= 0);
+        rapidrpc::FdEvent event_a(fd_a);
+        rapidrpc::FdEvent event_b(fd_b);
+
+        auto on_read = [&](int fd, rapidrpc::FdEvent *other) {
+            uint64_t value = 0;
+            CHECK(read(fd, &value, sizeof(value)) == sizeof(value));
+            result.m_calls++;
+            result.m_in_loop = loop->isInLoopThread();
+            other->clearEvent(rapidrpc::TriggerEvent::IN_EVENT);
+            loop->deleteEpollEvent(other);
+            loop->stop();
+        };
+        event_a.listen(rapidrpc::TriggerEvent::IN_EVENT, [&]() { on_read(fd_a, &event_b); });
+        event_b.listen(rapidrpc::TriggerEvent::IN_EVENT, [&]() { on_read(fd_b, &event_a); });
+        loop->addEpollEvent(&event_a);
+        loop->addEpollEvent(&event_b);
+        loop->loop();
+
+        result.m_max_queue = loop->getStats().m_queue_depth.m_max;
+        loop->deleteEpollEvent(&event_a);
+        loop->deleteEpollEvent(&event_b);
+        close(fd_a);
+        close(fd_b);
+        delete loop;
+    });
+    thread.join();
+    return result;
+}
+
+int main() {
+    rapidrpc::Config::SetGlobalConfig(nullptr);
+    rapidrpc::Config::GetGlobalConfig()->m_log_level = "ERROR";
+    rapidrpc::Logger::InitGlobalLogger();
+
+    // 直接分发: 先执行的回调取消了另一个 fd, 同一批中的另一个事件被丢弃; 任务队列始终为空
+    DispatchResult direct = run_dispatch(true);
+    CHECK(direct.m_calls == 1);
+    CHECK(direct.m_in_loop);
+    CHECK(direct.m_max_queue == 0);
+    printf("test_direct_dispatch success\n");
+
+    // 任务队列分发: 回调经过任务队列执行
+    DispatchResult queued = run_dispatch(false);
+    CHECK(queued.m_calls == 1);
+    CHECK(queued.m_in_loop);
+    CHECK(queued.m_max_queue >= 1);
+    printf("test_queued_dispatch success\n");
+    return 0;
+}
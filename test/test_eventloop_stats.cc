@@ -0,0 +1,94 @@
+/**
+ * 测试 EventLoop 运行指标: 直方图的分桶和百分位数，以及通过 IOThreadGroup 读取各个 IO 线程的统计
+ */
+
+#include "rapidrpc/common/histogram.h"
+#include "rapidrpc/common/log.h"
+#include "rapidrpc/common/config.h"
+#include "rapidrpc/net/io_thread_group.h"
+#include "rapidrpc/net/timer_event.h"
+#include "test_util.h"
+
+#include <stdio.h>
+#include <thread>
+#include <chrono>
+#include <atomic>
+
+void test_histogram() {
+    CHECK(rapidrpc::Histogram::BucketIndex(0) == 0);
+    CHECK(rapidrpc::Histogram::BucketIndex(1) == 1);
+    CHECK(rapidrpc::Histogram::BucketIndex(3) == 2);
+    CHECK(rapidrpc::Histogram::BucketIndex(4) == 3);
+    CHECK(rapidrpc::Histogram::BucketIndex(UINT64_MAX) == rapidrpc::HistogramSnapshot::BUCKETS - 1);
+
+    rapidrpc::Histogram histogram;
+    CHECK(histogram.snapshot().percentile(99) == 0);
+    // 90 个 10, 10 个 1000
+    for (int i = 0; i < 90; i++) {
+        histogram.record(10);
+    }
+    for (int i = 0; i < 10; i++) {
+        histogram.record(1000);
+    }
+    rapidrpc::HistogramSnapshot snapshot = histogram.snapshot();
+    CHECK(snapshot.m_count == 100);
+    CHECK(snapshot.m_sum == 90 * 10 + 10 * 1000);
+    CHECK(snapshot.m_max == 1000);
+    // 10 在 [8, 16) 桶中, 1000 在 [512, 1024) 桶中, 不超过最大值
+    CHECK(snapshot.percentile(50) == 15);
+    CHECK(snapshot.percentile(99) == 1000);
+    printf("test_histogram success, %s\n", snapshot.toString().c_str());
+}
+
+void test_io_thread_group_stats() {
+    rapidrpc::IOThreadGroup group(2);
+    group.start();
+
+    // 每个 IO 线程执行一些任务和定时任务
+    std::atomic<int> timer_count{0};
+    std::atomic<int> task_count{0};
+    for (int i = 0; i < 2; i++) {
+        rapidrpc::EventLoop *loop = group.getIOThread()->getEventLoop();
+        for (int j = 0; j < 100; j++) {
+            loop->addTask([&task_count]() { task_count++; }, true);
+        }
+        loop->addTimerEvent(std::make_shared<rapidrpc::TimerEvent>(10, false, [&timer_count]() { timer_count++; }));
+    }
+    for (int i = 0; i < 100 && (timer_count < 2 || task_count < 200); i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    CHECK(timer_count == 2 && task_count == 200);
+
+    std::vector<rapidrpc::EventLoopStats> stats = group.getStats();
+    CHECK(stats.size() == 2);
+    for (size_t i = 0; i < stats.size(); i++) {
+        CHECK(stats[i].m_poll_wait_us.m_count > 0);
+        CHECK(stats[i].m_handler_us.m_count > 0);
+        CHECK(stats[i].m_ready_events.m_max > 0);
+        CHECK(stats[i].m_queue_depth.m_sum >= 100);
+        CHECK(stats[i].m_timer_lag_us.m_count == 1);
+        printf("io thread [%lu]\n  poll wait us: %s\n  handler us: %s\n  ready events: %s\n  queue depth: %s\n"
+               "  timer lag us: %s\n",
+               i, stats[i].m_poll_wait_us.toString().c_str(), stats[i].m_handler_us.toString().c_str(),
+               stats[i].m_ready_events.toString().c_str(), stats[i].m_queue_depth.toString().c_str(),
+               stats[i].m_timer_lag_us.toString().c_str());
+    }
+
+    for (int i = 0; i < 2; i++) {
+        group.getIOThread()->getEventLoop()->stop();
+    }
+    group.join();
+    printf("test_io_thread_group_stats success\n");
+}
+
+int main() {
+    rapidrpc::Config::SetGlobalConfig(nullptr);
+    rapidrpc::Config::GetGlobalConfig()->m_log_level = "ERROR";
+    rapidrpc::Logger::InitGlobalLogger();
+
+    test_histogram();
+    test_io_thread_group_stats();
+
+    rapidrpc::Logger::GetGlobalLogger()->flushAndStop();
+    return 0;
+}
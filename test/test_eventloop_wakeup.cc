@@ -0,0 +1,72 @@
+/**
+ * 测试 EventLoop 唤醒合并: 其他线程连续添加一批任务(is_wakeup = true)时只写一次 wakeup fd,
+ * EventLoop 没有阻塞(正在执行任务)时不写 wakeup fd
+ */
+
+#include "rapidrpc/net/eventloop.h"
+#include "rapidrpc/common/log.h"
+#include "rapidrpc/common/config.h"
+#include "test_util.h"
+
+#include <stdio.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+// 等待 EventLoop 阻塞在 epoll_wait 中(空闲)
+void wait_idle() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+}
+
+int main() {
+    rapidrpc::Config::SetGlobalConfig(nullptr);
+    rapidrpc::Config::GetGlobalConfig()->m_log_level = "ERROR";
+    rapidrpc::Logger::InitGlobalLogger();
+
+    std::atomic<rapidrpc::EventLoop *> loop{nullptr};
+    std::thread thread([&loop]() {
+        rapidrpc::EventLoop *current = rapidrpc::EventLoop::GetCurrentEventLoop();
+        loop = current;
+        current->loop();
+        delete current;
+    });
+    while (!loop) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    wait_idle();
+    CHECK(loop.load()->getStats().m_wakeup_writes == 0);
+
+    const int batch_size = 1000;
+    std::atomic<int> executed{0};
+    for (int batch = 1; batch <= 3; batch++) {
+        // 第一个任务阻塞 EventLoop 直到这一批全部添加, 之后的唤醒都应该被合并
+        std::atomic<bool> added{false};
+        loop.load()->addTask(
+            [&added]() {
+                while (!added) {
+                    std::this_thread::yield();
+                }
+            },
+            true);
+        for (int i = 1; i < batch_size; i++) {
+            loop.load()->addTask([&executed]() { executed++; }, true);
+        }
+        added = true;
+        while (executed < batch * (batch_size - 1)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        wait_idle();
+        uint64_t writes = loop.load()->getStats().m_wakeup_writes;
+        printf("batch [%d], %d tasks, wakeup fd writes [%lu]\n", batch, batch_size, writes);
+        CHECK(writes == static_cast<uint64_t>(batch));
+    }
+
+    // 不要求唤醒的任务不写 wakeup fd
+    loop.load()->addTask([&executed]() { executed++; }, false);
+    CHECK(loop.load()->getStats().m_wakeup_writes == 3);
+
+    loop.load()->stop();
+    thread.join();
+    printf("test_wakeup_coalescing success\n");
+    return 0;
+}
@@ -0,0 +1,117 @@
+/**
+ * 测试 FdEventGroup: 多个线程同时获取相同的 fd 得到同一个 FdEvent(竞争发布时只保留一个)，
+ * FdEvent 按需分配，跨段/较大的 fd 可以获取，无效的 fd 返回 nullptr；以及并发查找的吞吐
+ */
+
+#include "rapidrpc/net/fd_event_group.h"
+#include "rapidrpc/common/log.h"
+#include "rapidrpc/common/config.h"
+#include "rapidrpc/common/util.h"
+#include "test_util.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <unistd.h>
+
+void test_lazy_allocation() {
+    rapidrpc::FdEventGroup group;
+    CHECK(group.getAllocatedCount() == 0);
+
+    rapidrpc::FdEvent *event = group.getFdEvent(3);
+    CHECK(event && event->getFd() == 3);
+    CHECK(group.getFdEvent(3) == event);
+    CHECK(group.getAllocatedCount() == 1);
+
+    // 跨段和较大的 fd, 只分配访问到的 FdEvent
+    int large_fd = rapidrpc::FdEventGroup::MAX_FD - 1;
+    CHECK(group.getFdEvent(rapidrpc::FdEventGroup::SEGMENT_SIZE)->getFd() == rapidrpc::FdEventGroup::SEGMENT_SIZE);
+    CHECK(group.getFdEvent(large_fd)->getFd() == large_fd);
+    CHECK(group.getAllocatedCount() == 3);
+
+    // 无效的 fd
+    CHECK(group.getFdEvent(-1) == nullptr);
+    CHECK(group.getFdEvent(rapidrpc::FdEventGroup::MAX_FD) == nullptr);
+    CHECK(group.getAllocatedCount() == 3);
+
+    // close 后重新分配到相同的 fd, 复用同一个 FdEvent
+    int fd = dup(0);
+    CHECK(fd >= 0);
+    rapidrpc::FdEvent *dup_event = group.getFdEvent(fd);
+    dup_event->close();
+    int fd2 = dup(0);
+    CHECK(fd2 == fd);
+    CHECK(group.getFdEvent(fd2) == dup_event);
+    dup_event->close();
+    printf("test_lazy_allocation success\n");
+}
+
+// 多个线程同时获取相同的 fd 集合, 每个 fd 只发布一个 FdEvent
+void test_concurrent_publish(int threads, int fds) {
+    rapidrpc::FdEventGroup group;
+    std::vector<std::vector<rapidrpc::FdEvent *>> results(threads, std::vector<rapidrpc::FdEvent *>(fds));
+    std::atomic<int> ready{0};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            ready++;
+            while (ready < threads) {
+            }
+            // 不同的线程以不同的顺序访问，增加竞争
+            for (int i = 0; i < fds; i++) {
+                int fd = (t % 2 == 0) ? i : fds - 1 - i;
+                results[t][fd] = group.getFdEvent(fd);
+            }
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    for (int fd = 0; fd < fds; fd++) {
+        CHECK(results[0][fd] && results[0][fd]->getFd() == fd);
+        for (int t = 1; t < threads; t++) {
+            CHECK(results[t][fd] == results[0][fd]);
+        }
+    }
+    CHECK(group.getAllocatedCount() == fds);
+    printf("test_concurrent_publish success, threads [%d], fds [%d]\n", threads, fds);
+}
+
+// 已经分配后的并发查找
+void bench_lookup(int threads, int lookups) {
+    rapidrpc::FdEventGroup group;
+    for (int fd = 0; fd < 65536; fd++) {
+        group.getFdEvent(fd);
+    }
+    std::vector<std::thread> workers;
+    int64_t start = rapidrpc::getMonotonicUs();
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&group, lookups, t]() {
+            for (int i = 0; i < lookups; i++) {
+                CHECK(group.getFdEvent((i * 7 + t) & 65535));
+            }
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    int64_t cost = rapidrpc::getMonotonicUs() - start;
+    printf("bench_lookup: threads [%d], %.2f Mlookups/s\n", threads,
+           static_cast<double>(lookups) * threads / (cost > 0 ? cost : 1));
+}
+
+int main() {
+    rapidrpc::Config::SetGlobalConfig(nullptr);
+    rapidrpc::Config::GetGlobalConfig()->m_log_level = "ERROR";
+    rapidrpc::Logger::InitGlobalLogger();
+
+    test_lazy_allocation();
+    test_concurrent_publish(8, 5000);
+    test_concurrent_publish(16, 3000);
+    bench_lookup(4, 10000000);
+
+    rapidrpc::Logger::GetGlobalLogger()->flushAndStop();
+    return 0;
+}
@@ -0,0 +1,155 @@
+/**
+ * 测试 FdEvent 的代数: fd 关闭后被复用(FdEventGroup 中是同一个 FdEvent)时,
+ * 同一批中旧连接的就绪事件、以及关闭前提交的跨线程删除任务不会作用到新连接上
+ */
+
+#include "rapidrpc/net/eventloop.h"
+#include "rapidrpc/net/io_thread.h"
+#include "rapidrpc/net/fd_event.h"
+#include "rapidrpc/common/log.h"
+#include "rapidrpc/common/config.h"
+#include "test_util.h"
+
+#include <unistd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <thread>
+#include <atomic>
+#include <chrono>
+
+void test_epoll_data() {
+    int fds[2];
+    CHECK(pipe(fds) == 0);
+    rapidrpc::FdEvent event(fds[0]);
+    event.listen(rapidrpc::TriggerEvent::IN_EVENT, []() {});
+    uint32_t generation = 0;
+    CHECK(rapidrpc::FdEvent::DecodeEpollData(event.getEpollEvent().data.u64, &generation) == &event);
+    CHECK(generation == 0 && !event.isStale(generation));
+
+    event.close();
+    close(fds[1]);
+    CHECK(event.getGeneration() == 1 && event.isStale(generation));
+    CHECK(rapidrpc::FdEvent::DecodeEpollData(event.getEpollEvent().data.u64, &generation) == &event);
+    CHECK(generation == 1 && !event.isStale(generation));
+    printf("test_epoll_data success\n");
+}
+
+/**
+ * 两个 fd 同时可读，先执行的回调关闭另一个 fd, 并用同一个 FdEvent 监听复用该 fd 的新 pipe(不可读)
+ * 同一批中另一个 fd 的旧事件应该被丢弃，不能执行新的回调
+ */
+void test_stale_event_in_batch() {
+    rapidrpc::EventLoop *loop = rapidrpc::EventLoop::GetCurrentEventLoop();
+    uint64_t stale_before = loop->getStats().m_stale_events;
+
+    int fds[2][2];
+    CHECK(pipe(fds[0]) == 0);
+    CHECK(pipe(fds[1]) == 0);
+    CHECK(write(fds[0][1], "x", 1) == 1);
+    CHECK(write(fds[1][1], "x", 1) == 1);
+
+    rapidrpc::FdEvent events[2] = {rapidrpc::FdEvent(fds[0][0]), rapidrpc::FdEvent(fds[1][0])};
+    int first = -1;
+    bool reused_run = false;
+    for (int i = 0; i < 2; i++) {
+        events[i].listen(rapidrpc::TriggerEvent::IN_EVENT, [&, i]() {
+            if (first >= 0) {
+                return;
+            }
+            first = i;
+            char c;
+            CHECK(read(fds[i][0], &c, 1) == 1);
+
+            int other = 1 - i;
+            events[other].close();
+            close(fds[other][1]);
+            CHECK(pipe(fds[other]) == 0);
+            CHECK(fds[other][0] == events[other].getFd());
+            events[other].listen(rapidrpc::TriggerEvent::IN_EVENT, [&reused_run]() { reused_run = true; });
+            loop->addEpollEvent(&events[other]);
+            loop->addTask([loop]() { loop->stop(); });
+        });
+        loop->addEpollEvent(&events[i]);
+    }
+    loop->loop();
+
+    CHECK(first >= 0);
+    CHECK(!reused_run);
+    CHECK(loop->getStats().m_stale_events - stale_before == 1);
+    for (int i = 0; i < 2; i++) {
+        loop->deleteEpollEvent(&events[i]);
+        events[i].close();
+        close(fds[i][1]);
+    }
+    printf("test_stale_event_in_batch success\n");
+}
+
+/**
+ * 其他线程提交删除任务后立即关闭 fd, 删除任务执行前 IO 线程已经用同一个 FdEvent 注册了复用该 fd 的新 pipe
+ * 过期的删除任务应该被丢弃，新的 pipe 仍然可以收到事件
+ */
+void test_stale_delete_task() {
+    rapidrpc::IOThread io_thread;
+    io_thread.start();
+    rapidrpc::EventLoop *loop = io_thread.getEventLoop();
+
+    int fds[2];
+    CHECK(pipe(fds) == 0);
+    rapidrpc::FdEvent event(fds[0]);
+    event.listen(rapidrpc::TriggerEvent::IN_EVENT, []() {});
+    loop->addEpollEvent(&event);
+    for (int i = 0; i < 100 && !event.isRegistered(); i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    CHECK(event.isRegistered());
+
+    std::atomic<bool> closed{false};
+    std::atomic<bool> reused_run{false};
+    loop->addTask(
+        [&]() {
+            while (!closed) {
+                std::this_thread::yield();
+            }
+            int old_fd = event.getFd();
+            CHECK(pipe(fds) == 0);
+            CHECK(fds[0] == old_fd);
+            event.listen(rapidrpc::TriggerEvent::IN_EVENT, [&]() {
+                char c;
+                CHECK(read(fds[0], &c, 1) == 1);
+                reused_run = true;
+            });
+            loop->addEpollEvent(&event);
+            CHECK(write(fds[1], "x", 1) == 1);
+        },
+        true);
+    // 删除任务排在上面的任务之后执行
+    loop->deleteEpollEvent(&event);
+    event.close();
+    close(fds[1]);
+    closed = true;
+
+    for (int i = 0; i < 1000 && !reused_run; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    CHECK(reused_run);
+
+    loop->deleteEpollEvent(&event);
+    loop->stop();
+    io_thread.join();
+    event.close();
+    close(fds[1]);
+    printf("test_stale_delete_task success\n");
+}
+
+int main() {
+    rapidrpc::Config::SetGlobalConfig(nullptr);
+    rapidrpc::Config::GetGlobalConfig()->m_log_level = "ERROR";
+    rapidrpc::Logger::InitGlobalLogger();
+
+    test_epoll_data();
+    std::thread(test_stale_event_in_batch).join();
+    test_stale_delete_task();
+
+    rapidrpc::Logger::GetGlobalLogger()->flushAndStop();
+    return 0;
+}
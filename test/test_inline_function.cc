@@ -0,0 +1,147 @@
+/**
+ * 测试 InlineFunction: 小对象内联存储，只能移动；
+ * 以及稳定状态下一次完整的 RPC 调用(客户端 + 服务端)不会因为回调函数分配堆内存
+ */
+
+#include "rapidrpc/common/inline_function.h"
+#include "rapidrpc/common/log.h"
+#include "rapidrpc/common/config.h"
+#include "rapidrpc/net/tcp/net_addr.h"
+#include "rapidrpc/net/tcp/tcp_server.h"
+#include "rapidrpc/net/rpc/dispatcher.h"
+#include "rapidrpc/net/rpc/rpc_channel.h"
+#include "rapidrpc/net/rpc/rpc_controller.h"
+#include "rapidrpc/net/rpc/rpc_closure.h"
+#include "order.pb.h"
+#include "test_util.h"
+
+#include <google/protobuf/service.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <chrono>
+
+static const char *g_server_addr = "127.0.0.1:12346";
+static std::atomic<int> g_success_count{0};
+
+class OrderImpl: public Order {
+public:
+    void makeOrder(google::protobuf::RpcController *controller, const ::makeOrderRequest *request,
+                   ::makeOrderResponse *response, google::protobuf::Closure *done) {
+        response->set_ret_code(0);
+        response->set_res_info("success");
+        response->set_order_id("20240101");
+    }
+};
+
+void test_inline_function() {
+    uint64_t allocs = rapidrpc::Task::HeapAllocations();
+
+    // 小对象内联存储
+    int i = 0;
+    auto p = std::make_shared<int>(1);
+    rapidrpc::Task small([&i, p]() {
+        i += *p;
+    });
+    small();
+    CHECK(i == 1);
+    CHECK(rapidrpc::Task::HeapAllocations() == allocs);
+
+    // 移动后原对象为空
+    rapidrpc::Task moved(std::move(small));
+    CHECK(!small);
+    moved();
+    CHECK(i == 2);
+
+    // 只能移动的捕获对象
+    std::unique_ptr<int> up(new int(10));
+    rapidrpc::InlineFunction<int(int)> add([up = std::move(up)](int x) {
+        return *up + x;
+    });
+    CHECK(add(5) == 15);
+    CHECK(rapidrpc::Task::HeapAllocations() == allocs);
+
+    // 超过内联大小，退化为堆分配
+    char big[128] = {0};
+    rapidrpc::Task large([big, &i]() {
+        i += big[0] + 1;
+    });
+    large();
+    CHECK(i == 3);
+    CHECK(rapidrpc::Task::HeapAllocations() == allocs + 1);
+
+    // 空的 std::function / nullptr
+    std::function<void()> empty_fn;
+    rapidrpc::Task empty(empty_fn);
+    CHECK(!empty);
+    moved = nullptr;
+    CHECK(!moved);
+
+    // 释放捕获的变量
+    CHECK(p.use_count() == 1);
+
+    printf("test_inline_function success\n");
+}
+
+// 每个客户端线程只能进行一次 rpc 调用(TcpClient 关闭时停止 EventLoop)
+void call_rpc() {
+    NEW_RPC_MESSAGE(request, makeOrderRequest);
+    NEW_RPC_MESSAGE(response, makeOrderResponse);
+    request->set_price(100);
+    request->set_goods("apple");
+
+    NEW_RPC_CONTROLLER(controller);
+    controller->SetTimeout(2000);
+
+    auto done = std::make_shared<rapidrpc::RpcClosure>([controller]() {
+        if (!controller->Failed()) {
+            g_success_count++;
+        }
+    });
+    CALL_RPC(g_server_addr, Order_Stub, makeOrder, controller, request, response, done);
+}
+
+void test_rpc_no_callback_alloc() {
+    rapidrpc::Dispatcher::GetDispatcher()->registerService(std::make_shared<OrderImpl>());
+
+    std::thread server([]() {
+        rapidrpc::TcpServer tcp_server(std::make_shared<rapidrpc::IpNetAddr>(g_server_addr));
+        tcp_server.start();
+    });
+    server.detach();
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    // 预热: 建立服务端 IO 线程等一次性的对象
+    std::thread(call_rpc).join();
+    CHECK(g_success_count == 1);
+
+    uint64_t allocs = rapidrpc::Task::HeapAllocations();
+    int rpc_count = 100;
+    for (int i = 0; i < rpc_count; i++) {
+        std::thread(call_rpc).join();
+    }
+    // 等待服务端处理完连接关闭
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    uint64_t delta = rapidrpc::Task::HeapAllocations() - allocs;
+
+    printf("rpc success: %d/%d, callback heap allocations: %lu\n", g_success_count.load() - 1, rpc_count, delta);
+    CHECK(g_success_count == rpc_count + 1);
+    CHECK(delta == 0);
+
+    printf("test_rpc_no_callback_alloc success\n");
+}
+
+int main() {
+    rapidrpc::Config::SetGlobalConfig(nullptr);
+    rapidrpc::Config::GetGlobalConfig()->m_log_level = "ERROR";
+    rapidrpc::Config::GetGlobalConfig()->m_io_threads = 2;
+    rapidrpc::Logger::InitGlobalLogger();
+
+    test_inline_function();
+    test_rpc_no_callback_alloc();
+
+    rapidrpc::Logger::GetGlobalLogger()->flushAndStop();
+    return 0;
+}
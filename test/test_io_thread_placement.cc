@@ -0,0 +1,242 @@
+/**
+ * 测试新连接的放置策略: 不均匀的连接组合下(每 4 个连接中 1 个长连接、发送大量数据，其余为很快关闭的短连接)
+ * 轮询会把所有长连接放到同一个 IO 线程, least_connections/least_queued_bytes 均匀分布；
+ * p2c_busy 避开繁忙的 IO 线程;
+ * TcpServer 的真实连接: 建立、发送缓冲区堆积响应、关闭后 IO 线程的连接数和待发送字节数回到 0
+ */
+
+#include "rapidrpc/net/io_thread_group.h"
+#include "rapidrpc/net/io_thread_placement.h"
+#include "rapidrpc/net/tcp/net_addr.h"
+#include "rapidrpc/net/tcp/tcp_server.h"
+#include "rapidrpc/net/rpc/dispatcher.h"
+#include "rapidrpc/common/log.h"
+#include "rapidrpc/common/config.h"
+#include "rapidrpc/common/util.h"
+#include "order.pb.h"
+#include "test_util.h"
+
+#include <google/protobuf/service.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+
+static const int g_io_threads = 4;
+
+// 响应的 order_id 为 price 个字节, 用于在连接的发送缓冲区中堆积数据
+class OrderImpl: public Order {
+public:
+    void makeOrder(google::protobuf::RpcController *controller, const ::makeOrderRequest *request,
+                   ::makeOrderResponse *response, google::protobuf::Closure *done) {
+        response->set_ret_code(0);
+        response->set_order_id(std::string(request->price(), 'x'));
+    }
+};
+
+// 等待 cond 成立, 最多 timeout_ms
+bool wait_for(std::function<bool()> cond, int timeout_ms) {
+    for (int i = 0; i < timeout_ms / 10; i++) {
+        if (cond()) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return cond();
+}
+
+/**
+ * @brief 模拟 connections 个连接(与 TcpConnection 相同地更新 EventLoop 的负载计数)
+ * @return 每个 IO 线程上的长连接数
+ */
+std::vector<int> place_skewed(rapidrpc::IOThreadGroup &group, int connections) {
+    std::vector<int> heavy(g_io_threads, 0);
+    std::vector<rapidrpc::EventLoop *> heavy_loops;
+    rapidrpc::EventLoop *light_loop = nullptr;
+    for (int i = 0; i < connections; i++) {
+        // 上一个短连接在下一个连接到达前关闭
+        if (light_loop) {
+            light_loop->addConnectionCount(-1);
+            light_loop = nullptr;
+        }
+        rapidrpc::IOThread *io_thread = group.getIOThread();
+        rapidrpc::EventLoop *loop = io_thread->getEventLoop();
+        loop->addConnectionCount(1);
+        if (i % g_io_threads == 0) {
+            loop->addQueuedBytes(64 * 1024);
+            heavy_loops.push_back(loop);
+            for (int t = 0; t < g_io_threads; t++) {
+                if (group.getIOThread(t) == io_thread) {
+                    heavy[t]++;
+                }
+            }
+        }
+        else {
+            light_loop = loop;
+        }
+    }
+    // 恢复计数
+    if (light_loop) {
+        light_loop->addConnectionCount(-1);
+    }
+    for (auto loop : heavy_loops) {
+        loop->addConnectionCount(-1);
+        loop->addQueuedBytes(-64 * 1024);
+    }
+    return heavy;
+}
+
+// 最多的线程与平均值的比值, 1 为完全均匀
+double imbalance(const std::vector<int> &counts) {
+    double sum = 0;
+    for (int count : counts) {
+        sum += count;
+    }
+    return *std::max_element(counts.begin(), counts.end()) / (sum / counts.size());
+}
+
+void test_skewed_mix() {
+    rapidrpc::IOThreadGroup group(g_io_threads);
+    group.start();
+
+    printf("%-20s %-24s %-10s\n", "placement", "heavy conns per thread", "max/avg");
+    double rr_imbalance = 0;
+    for (std::string type : {"round_robin", "least_connections", "least_queued_bytes"}) {
+        group.setPlacement(rapidrpc::IOThreadPlacement::Create(type));
+        CHECK(type == group.getPlacement()->getName());
+        std::vector<int> heavy = place_skewed(group, 400);
+        double value = imbalance(heavy);
+        printf("%-20s [%3d %3d %3d %3d]        %-10.2f\n", type.c_str(), heavy[0], heavy[1], heavy[2], heavy[3], value);
+        if (type == "round_robin") {
+            rr_imbalance = value;
+        }
+        else {
+            CHECK(value <= 1.1);
+        }
+        for (int t = 0; t < g_io_threads; t++) {
+            CHECK(group.getIOThread(t)->getEventLoop()->getConnectionCount() == 0);
+        }
+    }
+    CHECK(rr_imbalance >= 3.9);
+
+    for (int t = 0; t < g_io_threads; t++) {
+        group.getIOThread(t)->getEventLoop()->stop();
+    }
+    group.join();
+    printf("test_skewed_mix success\n");
+}
+
+// IO 线程 0 一直执行任务, p2c_busy 不会选择它; 其余线程按连接数均匀分布
+void test_p2c_busy() {
+    rapidrpc::IOThreadGroup group(g_io_threads);
+    group.start();
+
+    std::atomic<bool> stop{false};
+    rapidrpc::EventLoop *busy_loop = group.getIOThread(0)->getEventLoop();
+    std::function<void()> spin = [&]() {
+        int64_t end = rapidrpc::getMonotonicUs() + 2000;
+        while (rapidrpc::getMonotonicUs() < end) {
+        }
+        if (!stop) {
+            busy_loop->addTask(spin);
+        }
+    };
+    busy_loop->addTask(spin, true);
+    for (int i = 0; i < 100 && busy_loop->getBusyPermille() < 500; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    CHECK(busy_loop->getBusyPermille() >= 500);
+
+    group.setPlacement(rapidrpc::IOThreadPlacement::Create("p2c_busy"));
+    std::vector<int> counts(g_io_threads, 0);
+    for (int i = 0; i < 300; i++) {
+        rapidrpc::IOThread *io_thread = group.getIOThread();
+        io_thread->getEventLoop()->addConnectionCount(1);
+        for (int t = 0; t < g_io_threads; t++) {
+            if (group.getIOThread(t) == io_thread) {
+                counts[t]++;
+            }
+        }
+    }
+    printf("p2c_busy: busy thread [%d permille], conns per thread [%d %d %d %d]\n", busy_loop->getBusyPermille(),
+           counts[0], counts[1], counts[2], counts[3]);
+    CHECK(counts[0] == 0);
+    CHECK(imbalance(std::vector<int>(counts.begin() + 1, counts.end())) <= 1.1);
+    CHECK(group.getStats()[1].m_connections == counts[1]);
+
+    stop = true;
+    for (int t = 0; t < g_io_threads; t++) {
+        group.getIOThread(t)->getEventLoop()->stop();
+    }
+    group.join();
+    printf("test_p2c_busy success\n");
+}
+
+// TcpConnection 计入和减去所在 IO 线程的负载(m_load_counted/updateQueuedBytes/releaseLoad)
+void test_server_load(int port) {
+    rapidrpc::TcpServer *server = nullptr;
+    std::thread thread([&server, port]() {
+        server = new rapidrpc::TcpServer(std::make_shared<rapidrpc::IpNetAddr>("127.0.0.1:" + std::to_string(port)));
+        server->start();
+    });
+    thread.detach();
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    rapidrpc::IOThreadGroup *group = server->getIOThreadGroup();
+    auto total = [group](int64_t rapidrpc::EventLoopStats::*field) {
+        int64_t sum = 0;
+        for (auto &stats : group->getStats()) {
+            sum += stats.*field;
+        }
+        return sum;
+    };
+    CHECK(total(&rapidrpc::EventLoopStats::m_connections) == 0);
+
+    std::vector<int> fds;
+    for (int i = 0; i < 8; i++) {
+        fds.push_back(connect_server(port));
+        // price 为 0 时响应序列化为空, dispatcher 会返回错误, 从 1 开始
+        call(fds[i], i + 1);
+    }
+    CHECK(total(&rapidrpc::EventLoopStats::m_connections) == 8);
+    // 响应发送后(客户端可能先于 IO 线程更新计数收到响应)待发送字节数回到 0
+    CHECK(wait_for([&]() { return total(&rapidrpc::EventLoopStats::m_queued_bytes) == 0; }, 1000));
+
+    // 客户端不读取, 大的响应堆积在服务端连接的发送缓冲区中
+    send_request(fds[0], 100, 16 * 1024 * 1024);
+    CHECK(wait_for([&]() { return total(&rapidrpc::EventLoopStats::m_queued_bytes) > 0; }, 3000));
+    int64_t queued = total(&rapidrpc::EventLoopStats::m_queued_bytes);
+
+    // 关闭后(包括有待发送数据的连接)连接数和待发送字节数都回到 0
+    for (int fd : fds) {
+        close(fd);
+    }
+    CHECK(wait_for(
+        [&]() {
+            return total(&rapidrpc::EventLoopStats::m_connections) == 0
+                   && total(&rapidrpc::EventLoopStats::m_queued_bytes) == 0;
+        },
+        3000));
+    printf("test_server_load success, queued [%ld] bytes before close\n", queued);
+}
+
+int main() {
+    rapidrpc::Config::SetGlobalConfig(nullptr);
+    rapidrpc::Config::GetGlobalConfig()->m_log_level = "ERROR";
+    rapidrpc::Config::GetGlobalConfig()->m_io_threads = 2;
+    rapidrpc::Logger::InitGlobalLogger();
+    rapidrpc::Dispatcher::GetDispatcher()->registerService(std::make_shared<OrderImpl>());
+
+    test_skewed_mix();
+    test_p2c_busy();
+    test_server_load(12355);
+
+    rapidrpc::Logger::GetGlobalLogger()->flushAndStop();
+    return 0;
+}
@@ -0,0 +1,228 @@
+/**
+ * 测试运行时调整 IO 线程数:
+ * 1. IOThreadGroup 增加/排空/释放线程, 恢复正在排空的线程; 没有启动的线程组也可以释放排空的线程
+ * 2. autoscale 按最少/最多线程数和平均繁忙比例增加或者排空线程，已经有线程在排空时不再排空
+ * 3. TcpServer 排空的线程不再分配新连接，已有连接继续处理，连接关闭后由主线程定时器释放; 增加的线程接收新连接
+ * 4. 配置 io_drain_timeout_ms 时排空超时后关闭剩余的连接
+ */
+
+#include "rapidrpc/common/log.h"
+#include "rapidrpc/common/config.h"
+#include "rapidrpc/net/io_thread_group.h"
+#include "rapidrpc/net/tcp/net_addr.h"
+#include "rapidrpc/net/tcp/tcp_server.h"
+#include "rapidrpc/net/rpc/dispatcher.h"
+#include "order.pb.h"
+#include "test_util.h"
+
+#include <google/protobuf/service.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+class OrderImpl: public Order {
+public:
+    void makeOrder(google::protobuf::RpcController *controller, const ::makeOrderRequest *request,
+                   ::makeOrderResponse *response, google::protobuf::Closure *done) {
+        response->set_ret_code(0);
+        response->set_order_id(std::to_string(request->price()));
+    }
+};
+
+// 等待 cond 成立, 最多 timeout_ms
+bool wait_for(std::function<bool()> cond, int timeout_ms) {
+    for (int i = 0; i < timeout_ms / 10; i++) {
+        if (cond()) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return cond();
+}
+
+void test_group_resize() {
+    rapidrpc::IOThreadGroup group(2);
+    group.start();
+    rapidrpc::IOThread *added = group.addIOThread();
+    CHECK(group.getSize() == 3);
+    CHECK(group.getIOThread(2) == added);
+
+    // 连接数相同时排空最后创建的线程
+    CHECK(group.drainIOThread() == added);
+    CHECK(group.getSize() == 2);
+    CHECK(group.getDrainingCount() == 1);
+    for (int i = 0; i < 10; i++) {
+        CHECK(group.getIOThread() != added);
+    }
+
+    // 恢复正在排空的线程
+    CHECK(group.addIOThread() == added);
+    CHECK(group.getSize() == 3);
+    CHECK(group.getDrainingCount() == 0);
+
+    // 有连接(或者等待业务线程池的响应)时不释放
+    CHECK(group.drainIOThread(added) == added);
+    added->getEventLoop()->addPendingReplies(1);
+    CHECK(group.reapDrained() == 0);
+    added->getEventLoop()->addPendingReplies(-1);
+    CHECK(group.reapDrained() == 1);
+    CHECK(group.getDrainingCount() == 0);
+
+    // 正在排空的线程不能再排空, 只剩一个线程时不能排空
+    rapidrpc::IOThread *first = group.getIOThread(0);
+    CHECK(group.drainIOThread(first) == first);
+    CHECK(group.drainIOThread(first) == nullptr);
+    CHECK(group.drainIOThread() == nullptr);
+    CHECK(group.getSize() == 1);
+    CHECK(group.reapDrained() == 1);
+
+    // 没有启动的线程组
+    rapidrpc::IOThreadGroup idle(2);
+    CHECK(idle.drainIOThread() != nullptr);
+    CHECK(idle.reapDrained() == 1);
+    CHECK(idle.getSize() == 1);
+    printf("test_group_resize success\n");
+}
+
+void test_autoscale() {
+    rapidrpc::IOThreadGroup group(1);
+    group.start();
+
+    rapidrpc::IOThreadAutoscale policy;
+    policy.m_min_threads = 3;
+    policy.m_max_threads = 4;
+    CHECK(group.autoscale(policy) == 1);
+    CHECK(group.autoscale(policy) == 1);
+    CHECK(group.autoscale(policy) == 0);
+    CHECK(group.getSize() == 3);
+
+    // 空闲: 每次排空一个，上一个排空结束前不再排空
+    policy.m_min_threads = 1;
+    CHECK(group.autoscale(policy) == -1);
+    CHECK(group.autoscale(policy) == 0);
+    CHECK(group.reapDrained() == 1);
+    CHECK(group.autoscale(policy) == -1);
+    CHECK(group.reapDrained() == 1);
+    CHECK(group.autoscale(policy) == 0);
+    CHECK(group.getSize() == 1);
+
+    // 繁忙: 线程一直执行任务
+    std::atomic<bool> stop{false};
+    std::atomic<bool> stopped{false};
+    rapidrpc::EventLoop *event_loop = group.getIOThread(0)->getEventLoop();
+    std::function<void()> spin = [&]() {
+        auto start = std::chrono::steady_clock::now();
+        while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(5)) {
+        }
+        if (stop) {
+            stopped = true;
+            return;
+        }
+        event_loop->addTask(spin, true);
+    };
+    event_loop->addTask(spin, true);
+    CHECK(wait_for([&]() { return event_loop->getBusyPermille() > 900; }, 2000));
+    policy.m_high_permille = 800;
+    CHECK(group.autoscale(policy) == 1);
+    CHECK(group.getSize() == 2);
+    stop = true;
+    CHECK(wait_for([&]() { return stopped.load(); }, 1000));
+
+    // 超过最多线程数时排空
+    policy.m_max_threads = 1;
+    CHECK(group.autoscale(policy) == -1);
+    CHECK(group.getSize() == 1);
+    CHECK(wait_for([&]() { return group.reapDrained() == 1; }, 1000));
+    printf("test_autoscale success\n");
+}
+
+void test_server_drain(int port) {
+    rapidrpc::TcpServer *server = nullptr;
+    std::thread thread([&server, port]() {
+        server = new rapidrpc::TcpServer(std::make_shared<rapidrpc::IpNetAddr>("127.0.0.1:" + std::to_string(port)));
+        server->start();
+    });
+    thread.detach();
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    rapidrpc::IOThreadGroup *group = server->getIOThreadGroup();
+    rapidrpc::IOThread *first = group->getIOThread(0);
+    rapidrpc::IOThread *second = group->getIOThread(1);
+
+    std::vector<int> old_fds;
+    for (int i = 0; i < 4; i++) {
+        old_fds.push_back(connect_server(port));
+        call(old_fds[i], i);
+    }
+    CHECK(second->getEventLoop()->getConnectionCount() == 2);
+
+    // 排空的线程不再分配新连接，已有连接继续处理
+    CHECK(server->drainIOThread(second));
+    std::vector<int> new_fds;
+    for (int i = 0; i < 2; i++) {
+        new_fds.push_back(connect_server(port));
+        call(new_fds[i], 100 + i);
+    }
+    CHECK(first->getEventLoop()->getConnectionCount() == 4);
+    CHECK(second->getEventLoop()->getConnectionCount() == 2);
+    for (int i = 0; i < 4; i++) {
+        call(old_fds[i], 200 + i);
+    }
+
+    // 连接关闭后由定时器释放
+    for (int fd : old_fds) {
+        close(fd);
+    }
+    CHECK(wait_for([&]() { return group->getDrainingCount() == 0; }, 3000));
+    CHECK(group->getSize() == 1);
+
+    // 增加的线程接收新连接
+    rapidrpc::IOThread *added = server->addIOThread();
+    CHECK(added != nullptr);
+    for (int i = 0; i < 2; i++) {
+        int fd = connect_server(port);
+        call(fd, 300 + i);
+        new_fds.push_back(fd);
+    }
+    CHECK(added->getEventLoop()->getConnectionCount() == 1);
+
+    // 排空超时后关闭剩余的连接
+    rapidrpc::Config::GetGlobalConfig()->m_io_drain_timeout_ms = 200;
+    CHECK(server->drainIOThread(added));
+    CHECK(wait_for([&]() { return group->getDrainingCount() == 0; }, 3000));
+    CHECK(group->getSize() == 1);
+    // 排空线程上的连接收到 FIN, 其他连接仍然可以请求
+    int closed = 0;
+    char buf[64];
+    for (int fd : new_fds) {
+        if (recv(fd, buf, sizeof(buf), MSG_DONTWAIT) == 0) {
+            closed++;
+            continue;
+        }
+        call(fd, 400 + fd);
+    }
+    CHECK(closed == 1);
+    for (int fd : new_fds) {
+        close(fd);
+    }
+    printf("test_server_drain success\n");
+}
+
+int main() {
+    rapidrpc::Config::SetGlobalConfig(nullptr);
+    rapidrpc::Config::GetGlobalConfig()->m_log_level = "ERROR";
+    rapidrpc::Config::GetGlobalConfig()->m_io_threads = 2;
+    rapidrpc::Logger::InitGlobalLogger();
+    rapidrpc::Dispatcher::GetDispatcher()->registerService(std::make_shared<OrderImpl>());
+
+    test_group_resize();
+    test_autoscale();
+    test_server_drain(12354);
+    return 0;
+}
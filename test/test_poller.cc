@@ -0,0 +1,142 @@
+/**
+ * 测试 Poller: epoll 和 io_uring 实现的语义一致(LT 模式)
+ */
+
+#include "rapidrpc/net/poller.h"
+#include "rapidrpc/net/epoll_poller.h"
+#include "rapidrpc/net/io_uring_poller.h"
+#include "rapidrpc/net/eventloop.h"
+#include "rapidrpc/common/log.h"
+#include "rapidrpc/common/config.h"
+#include "test_util.h"
+
+#include <unistd.h>
+#include <stdio.h>
+#include <string.h>
+#include <memory>
+
+// 返回的事件属于 expected(epoll data 中的指针), 且注册时的代数没有过期
+bool is_event(const epoll_event &event, rapidrpc::FdEvent *expected) {
+    uint32_t generation = 0;
+    rapidrpc::FdEvent *fd_event = rapidrpc::FdEvent::DecodeEpollData(event.data.u64, &generation);
+    return fd_event == expected && !fd_event->isStale(generation);
+}
+
+void test_poller(rapidrpc::Poller *poller) {
+    int fds[2];
+    CHECK(pipe(fds) == 0);
+    rapidrpc::FdEvent read_event(fds[0]);
+    read_event.setNonBlocking();
+    read_event.listen(rapidrpc::TriggerEvent::IN_EVENT, []() {});
+    poller->addEvent(&read_event);
+
+    epoll_event events[8];
+    // 没有数据，超时
+    CHECK(poller->poll(events, 8, 10) == 0);
+
+    CHECK(write(fds[1], "hello", 5) == 5);
+    int rt = poller->poll(events, 8, 1000);
+    CHECK(rt == 1);
+    CHECK(is_event(events[0], &read_event));
+    CHECK(events[0].events & EPOLLIN);
+
+    // LT: 没有读取数据，再次返回
+    rt = poller->poll(events, 8, 1000);
+    CHECK(rt == 1 && (events[0].events & EPOLLIN));
+
+    // 监听事件没有变化时重复添加
+    poller->addEvent(&read_event);
+    rt = poller->poll(events, 8, 1000);
+    CHECK(rt == 1);
+
+    // 读取后不再返回
+    char buf[16];
+    CHECK(read(fds[0], buf, sizeof(buf)) == 5);
+    CHECK(poller->poll(events, 8, 10) == 0);
+
+    // 修改监听事件: 写端监听可写
+    rapidrpc::FdEvent write_event(fds[1]);
+    write_event.listen(rapidrpc::TriggerEvent::OUT_EVENT, []() {});
+    poller->addEvent(&write_event);
+    rt = poller->poll(events, 8, 1000);
+    CHECK(rt == 1 && is_event(events[0], &write_event) && (events[0].events & EPOLLOUT));
+    write_event.clearEvent(rapidrpc::TriggerEvent::OUT_EVENT);
+    write_event.listen(rapidrpc::TriggerEvent::IN_EVENT, []() {});
+    poller->addEvent(&write_event);
+    CHECK(poller->poll(events, 8, 10) == 0);
+
+    // 删除后不再返回
+    CHECK(write(fds[1], "hello", 5) == 5);
+    poller->deleteEvent(&read_event);
+    CHECK(poller->poll(events, 8, 10) == 0);
+
+    // 重新添加
+    poller->addEvent(&read_event);
+    rt = poller->poll(events, 8, 1000);
+    CHECK(rt == 1 && is_event(events[0], &read_event));
+
+    poller->deleteEvent(&read_event);
+    poller->deleteEvent(&write_event);
+    close(fds[0]);
+    close(fds[1]);
+    printf("test_poller [%s] success\n", poller->getName());
+}
+
+// EventLoop 跳过监听事件没有变化的修改，并统计修改次数
+void test_eventloop_ctl_stats() {
+    rapidrpc::EventLoop *loop = rapidrpc::EventLoop::GetCurrentEventLoop();
+    rapidrpc::EventLoopStats before = loop->getStats();
+
+    int fds[2];
+    CHECK(pipe(fds) == 0);
+    rapidrpc::FdEvent event(fds[0]);
+    event.listen(rapidrpc::TriggerEvent::IN_EVENT, []() {});
+    loop->addEpollEvent(&event);
+    loop->addEpollEvent(&event); // 没有变化
+    loop->addEpollEvent(&event); // 没有变化
+    event.listen(rapidrpc::TriggerEvent::OUT_EVENT, []() {});
+    loop->addEpollEvent(&event); // 修改
+    loop->deleteEpollEvent(&event);
+
+    rapidrpc::EventLoopStats after = loop->getStats();
+    CHECK(after.m_ctl_calls - before.m_ctl_calls == 3);
+    CHECK(after.m_ctl_skipped - before.m_ctl_skipped == 2);
+
+    // 关闭 fd 后(没有删除)复用同一个 fd, 重新添加
+    loop->addEpollEvent(&event);
+    event.close();
+    close(fds[1]);
+    CHECK(pipe(fds) == 0);
+    rapidrpc::FdEvent reused(fds[0]);
+    reused.listen(rapidrpc::TriggerEvent::IN_EVENT, []() {});
+    loop->addEpollEvent(&reused);
+    CHECK(reused.isRegistered());
+    loop->deleteEpollEvent(&reused);
+    close(fds[0]);
+    close(fds[1]);
+
+    printf("test_eventloop_ctl_stats success, ctl calls [%lu], skipped [%lu]\n",
+           after.m_ctl_calls - before.m_ctl_calls, after.m_ctl_skipped - before.m_ctl_skipped);
+}
+
+int main() {
+    rapidrpc::Config::SetGlobalConfig(nullptr);
+    rapidrpc::Config::GetGlobalConfig()->m_log_level = "ERROR";
+    rapidrpc::Logger::InitGlobalLogger();
+
+    std::unique_ptr<rapidrpc::Poller> epoll_poller(new rapidrpc::EpollPoller());
+    test_poller(epoll_poller.get());
+
+    std::unique_ptr<rapidrpc::IoUringPoller> io_uring_poller(new rapidrpc::IoUringPoller());
+    if (io_uring_poller->init()) {
+        test_poller(io_uring_poller.get());
+    }
+    else {
+        printf("io_uring is not available, skip\n");
+    }
+
+    test_eventloop_ctl_stats();
+
+    rapidrpc::Logger::GetGlobalLogger()->flushAndStop();
+    return 0;
+}
@@ -0,0 +1,106 @@
+/**
+ * 测试 SO_REUSEPORT accept 模式: 每个 IO 线程有自己的监听 socket, 在 IO 线程中直接 accept 并处理连接
+ * 1. reuseport: 多个连接由内核分配到多个 IO 线程, 每个连接的请求在 accept 它的 IO 线程中执行
+ * 2. reuseport_cbpf: 挂载按 CPU 选择 socket 的 CBPF 程序后连接正常工作
+ */
+
+#include "rapidrpc/common/log.h"
+#include "rapidrpc/common/config.h"
+#include "rapidrpc/net/tcp/net_addr.h"
+#include "rapidrpc/net/tcp/tcp_server.h"
+#include "rapidrpc/net/rpc/dispatcher.h"
+#include "order.pb.h"
+#include "test_util.h"
+
+#include <google/protobuf/service.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 响应中带回执行服务的线程名称
+class OrderImpl: public Order {
+public:
+    void makeOrder(google::protobuf::RpcController *controller, const ::makeOrderRequest *request,
+                   ::makeOrderResponse *response, google::protobuf::Closure *done) {
+        char name[16] = {0};
+        pthread_getname_np(pthread_self(), name, sizeof(name));
+        response->set_ret_code(0);
+        response->set_res_info(name);
+        response->set_order_id(std::to_string(request->price()));
+    }
+};
+
+// 在新线程中创建并启动服务端(读取当前配置), 返回创建完成的 TcpServer
+rapidrpc::TcpServer *start_server(const std::string &accept_mode, int port) {
+    rapidrpc::Config::GetGlobalConfig()->m_accept_mode = accept_mode;
+    std::atomic<rapidrpc::TcpServer *> server{nullptr};
+    std::thread thread([&server, port]() {
+        std::string addr = "127.0.0.1:" + std::to_string(port);
+        rapidrpc::TcpServer *tcp_server = new rapidrpc::TcpServer(std::make_shared<rapidrpc::IpNetAddr>(addr));
+        server = tcp_server;
+        tcp_server->start();
+    });
+    thread.detach();
+    while (!server.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    return server.load();
+}
+
+void test_reuseport(const std::string &accept_mode, int port, int connections) {
+    rapidrpc::TcpServer *server = start_server(accept_mode, port);
+    CHECK(server->isReusePort());
+    rapidrpc::IOThreadGroup *group = server->getIOThreadGroup();
+
+    std::vector<int> fds;
+    std::map<std::string, int> threads; // 线程名称 -> 连接数
+    for (int i = 0; i < connections; i++) {
+        int fd = connect_server(port);
+        fds.push_back(fd);
+        // 同一个连接的请求始终在同一个 IO 线程中执行
+        std::string name = call(fd, i).res_info();
+        CHECK(name.compare(0, 12, "rapidrpc-io-") == 0);
+        CHECK(call(fd, i + connections).res_info() == name);
+        threads[name]++;
+    }
+
+    // 连接计入 accept 它的 IO 线程
+    int counted = 0;
+    for (int i = 0; i < group->getSize(); i++) {
+        int64_t count = group->getIOThread(i)->getEventLoop()->getConnectionCount();
+        auto it = threads.find("rapidrpc-io-" + std::to_string(i));
+        CHECK(count == (it == threads.end() ? 0 : it->second));
+        counted += count;
+    }
+    CHECK(counted == connections);
+    if (accept_mode == "reuseport") {
+        // 按四元组哈希, 64 个连接全部分配到同一个线程的概率可以忽略
+        CHECK(threads.size() > 1);
+    }
+
+    for (int fd : fds) {
+        close(fd);
+    }
+    printf("test_reuseport success, mode [%s], connections [%d], io threads used [%zu]\n", accept_mode.c_str(),
+           connections, threads.size());
+}
+
+int main() {
+    rapidrpc::Config::SetGlobalConfig(nullptr);
+    rapidrpc::Config::GetGlobalConfig()->m_log_level = "ERROR";
+    rapidrpc::Config::GetGlobalConfig()->m_io_threads = 4;
+    rapidrpc::Logger::InitGlobalLogger();
+    rapidrpc::Dispatcher::GetDispatcher()->registerService(std::make_shared<OrderImpl>());
+
+    test_reuseport("reuseport", 12350, 64);
+    test_reuseport("reuseport_cbpf", 12351, 16);
+    return 0;
+}
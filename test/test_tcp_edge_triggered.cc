@@ -0,0 +1,97 @@
+/**
+ * 测试边缘触发(EPOLLET)模式的 TcpConnection:
+ * 客户端一次性连续发送大量请求(流水线)，服务端每个请求返回较大的响应，
+ * 边缘触发模式需要读/写直到 EAGAIN，否则剩余的数据不会再次触发事件，响应会丢失或者卡住
+ */
+
+#include "rapidrpc/common/log.h"
+#include "rapidrpc/common/config.h"
+#include "rapidrpc/net/tcp/net_addr.h"
+#include "rapidrpc/net/tcp/tcp_server.h"
+#include "rapidrpc/net/rpc/dispatcher.h"
+#include "order.pb.h"
+#include "test_util.h"
+
+#include <google/protobuf/service.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <memory>
+#include <thread>
+#include <chrono>
+#include <vector>
+
+static const char *g_server_addr = "127.0.0.1:12347";
+
+// 响应中带回请求的 goods, 构造较大的响应，使服务端发送缓冲区写满
+class OrderImpl: public Order {
+public:
+    void makeOrder(google::protobuf::RpcController *controller, const ::makeOrderRequest *request,
+                   ::makeOrderResponse *response, google::protobuf::Closure *done) {
+        response->set_ret_code(0);
+        response->set_res_info(request->goods());
+        response->set_order_id(std::to_string(request->price()));
+    }
+};
+
+// 一次发送 batch 个请求，每个请求带 payload 字节
+void test_pipelined_burst(int total, int batch, int payload) {
+    int fd = connect_server(12347);
+    std::string goods(payload, 'x');
+
+    std::thread writer([fd, total, batch, &goods]() {
+        for (int i = 0; i < total; i += batch) {
+            std::vector<rapidrpc::AbstractProtocol::s_ptr> messages;
+            for (int j = i; j < i + batch && j < total; j++) {
+                makeOrderRequest request;
+                request.set_price(j);
+                request.set_goods(goods);
+                messages.push_back(make_request(j, request));
+            }
+            send_messages(fd, messages);
+        }
+    });
+
+    // 读取全部响应，检查顺序和内容
+    ResponseReader reader(fd);
+    for (int received = 0; received < total; received++) {
+        auto resp = reader.next();
+        CHECK(resp->m_err_code == 0);
+        CHECK(resp->m_msg_id == std::to_string(received));
+        makeOrderResponse response;
+        CHECK(response.ParseFromString(resp->m_pb_data));
+        CHECK(response.order_id() == std::to_string(received));
+        CHECK(response.res_info().size() == goods.size());
+    }
+    writer.join();
+    close(fd);
+    printf("test_pipelined_burst success, requests [%d], batch [%d], payload [%d]\n", total, batch, payload);
+}
+
+int main() {
+    rapidrpc::Config::SetGlobalConfig(nullptr);
+    rapidrpc::Config::GetGlobalConfig()->m_log_level = "ERROR";
+    rapidrpc::Config::GetGlobalConfig()->m_io_threads = 2;
+    rapidrpc::Logger::InitGlobalLogger();
+
+    rapidrpc::Dispatcher::GetDispatcher()->registerService(std::make_shared<OrderImpl>());
+    std::thread server([]() {
+        rapidrpc::TcpServer tcp_server(std::make_shared<rapidrpc::IpNetAddr>(g_server_addr));
+        tcp_server.setEdgeTriggered(true);
+        tcp_server.start();
+    });
+    server.detach();
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    // 小请求，一次 read 包含多个请求
+    test_pipelined_burst(20000, 1000, 16);
+    // 大响应，服务端发送缓冲区写满后等待可写事件
+    test_pipelined_burst(2000, 200, 16 * 1024);
+    // 单个请求超过 socket 缓冲区
+    test_pipelined_burst(10, 10, 1024 * 1024);
+    // 每次可读事件最多读取 4KB, 剩余数据由任务队列继续读取(新连接创建时读取配置)
+    rapidrpc::Config::GetGlobalConfig()->m_conn_read_budget = 4096;
+    test_pipelined_burst(2000, 200, 16 * 1024);
+
+    rapidrpc::Logger::GetGlobalLogger()->flushAndStop();
+    return 0;
+}
@@ -0,0 +1,91 @@
+/**
+ * 测试 IO 线程的放置: CPU 列表的解析，IO 线程按 io_thread_cpus 绑定 CPU 并设置线程名称
+ */
+
+#include "rapidrpc/net/io_thread_group.h"
+#include "rapidrpc/common/log.h"
+#include "rapidrpc/common/config.h"
+#include "rapidrpc/common/util.h"
+#include "test_util.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+
+void test_parse_cpu_list() {
+    CHECK(rapidrpc::parseCpuList("") == std::vector<int>());
+    CHECK(rapidrpc::parseCpuList("3") == std::vector<int>({3}));
+    CHECK(rapidrpc::parseCpuList("0-3,8,10-11") == std::vector<int>({0, 1, 2, 3, 8, 10, 11}));
+    CHECK(rapidrpc::parseCpuList("1,,2,") == std::vector<int>({1, 2}));
+    // 格式错误
+    CHECK(rapidrpc::parseCpuList("a").empty());
+    CHECK(rapidrpc::parseCpuList("3-1").empty());
+    CHECK(rapidrpc::parseCpuList("0-3,x").empty());
+    CHECK(rapidrpc::parseCpuList("-1").empty());
+    CHECK(rapidrpc::parseCpuList("100000").empty());
+    printf("test_parse_cpu_list success\n");
+}
+
+// 每个 IO 线程绑定到 io_thread_cpus 中的第 i % n 个 CPU
+void test_io_thread_binding() {
+    // 使用当前进程允许的 CPU
+    cpu_set_t allowed;
+    CHECK(sched_getaffinity(0, sizeof(allowed), &allowed) == 0);
+    std::vector<int> cpus;
+    std::string cpu_list;
+    for (int cpu = 0; cpu < CPU_SETSIZE && cpus.size() < 2; cpu++) {
+        if (CPU_ISSET(cpu, &allowed)) {
+            cpus.push_back(cpu);
+            cpu_list += (cpu_list.empty() ? "" : ",") + std::to_string(cpu);
+        }
+    }
+    rapidrpc::Config::GetGlobalConfig()->m_io_thread_cpus = cpu_list;
+
+    const int io_threads = 3;
+    rapidrpc::IOThreadGroup group(io_threads);
+    group.start();
+    for (int i = 0; i < io_threads; i++) {
+        std::atomic<bool> done{false};
+        cpu_set_t set;
+        char name[16] = {0};
+        group.getIOThread(i)->getEventLoop()->addTask(
+            [&]() {
+                CHECK(sched_getaffinity(0, sizeof(set), &set) == 0);
+                CHECK(pthread_getname_np(pthread_self(), name, sizeof(name)) == 0);
+                done = true;
+            },
+            true);
+        while (!done) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        CHECK(CPU_COUNT(&set) == 1);
+        CHECK(CPU_ISSET(cpus[i % cpus.size()], &set));
+        CHECK(std::string(name) == "rapidrpc-io-" + std::to_string(i));
+        printf("io thread [%s] bound to cpu [%d]\n", name, cpus[i % cpus.size()]);
+    }
+    for (int i = 0; i < io_threads; i++) {
+        group.getIOThread(i)->getEventLoop()->stop();
+    }
+    group.join();
+    rapidrpc::Config::GetGlobalConfig()->m_io_thread_cpus = "";
+    printf("test_io_thread_binding success\n");
+}
+
+int main() {
+    rapidrpc::Config::SetGlobalConfig(nullptr);
+    rapidrpc::Config::GetGlobalConfig()->m_log_level = "ERROR";
+    rapidrpc::Logger::InitGlobalLogger();
+
+    test_parse_cpu_list();
+    test_io_thread_binding();
+
+    rapidrpc::Logger::GetGlobalLogger()->flushAndStop();
+    return 0;
+}
@@ -0,0 +1,110 @@
+/**
+ * 测试定时任务的删除: deleteTimerEvent 立即从 Timer 中移除并释放任务捕获的变量，
+ * 删除最近的任务后其余任务仍然按时执行(multimap 和时间轮两种模式);
+ * 其他线程添加/删除定时任务时转为 EventLoop 的任务执行
+ */
+
+#include "rapidrpc/net/eventloop.h"
+#include "rapidrpc/net/io_thread.h"
+#include "rapidrpc/common/log.h"
+#include "rapidrpc/common/config.h"
+#include "rapidrpc/common/util.h"
+#include "test_util.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+
+void test_timer_cancel(int64_t wheel_tick_ms) {
+    rapidrpc::EventLoop *loop = rapidrpc::EventLoop::GetCurrentEventLoop();
+    loop->setTimingWheel(wheel_tick_ms);
+
+    // 任务捕获的变量, 删除后应该立即释放
+    auto captured = std::make_shared<int>(0);
+    std::vector<rapidrpc::TimerEvent::s_ptr> events;
+    for (int i = 0; i < 100000; i++) {
+        auto event = std::make_shared<rapidrpc::TimerEvent>(1000 + i % 5000, false, [captured]() { (*captured)++; });
+        events.push_back(event);
+        loop->addTimerEvent(events.back());
+    }
+    CHECK(captured.use_count() == 100001);
+    for (auto &event : events) {
+        CHECK(event->isPending());
+        loop->deleteTimerEvent(event);
+        CHECK(!event->isPending() && event->isCanceled());
+        // Timer 不再持有引用
+        CHECK(event.use_count() == 1);
+    }
+    CHECK(captured.use_count() == 1);
+    // 重复删除没有影响
+    loop->deleteTimerEvent(events[0]);
+    events.clear();
+
+    // 删除最近的任务，后面的任务按时执行; 重复添加只执行一次
+    int64_t start = rapidrpc::getNowMs();
+    bool first_run = false;
+    int second_run = 0;
+    auto first = std::make_shared<rapidrpc::TimerEvent>(10, false, [&first_run]() { first_run = true; });
+    auto second = std::make_shared<rapidrpc::TimerEvent>(30, false, [&second_run]() { second_run++; });
+    auto stop = std::make_shared<rapidrpc::TimerEvent>(60, false, [loop]() { loop->stop(); });
+    loop->addTimerEvent(first);
+    loop->addTimerEvent(second);
+    loop->addTimerEvent(second);
+    loop->addTimerEvent(stop);
+    loop->deleteTimerEvent(first);
+    loop->loop();
+
+    int64_t cost = rapidrpc::getNowMs() - start;
+    CHECK(!first_run);
+    CHECK(second_run == 1);
+    CHECK(!second->isPending() && !stop->isPending());
+    CHECK(cost >= 60 && cost < 150);
+    printf("test_timer_cancel success, timing wheel tick [%ldms], cost [%ldms]\n", wheel_tick_ms, cost);
+}
+
+void test_timer_cross_thread() {
+    rapidrpc::IOThread io_thread;
+    io_thread.start();
+    rapidrpc::EventLoop *loop = io_thread.getEventLoop();
+
+    // 主线程添加 1000 个定时任务，删除其中一半
+    std::atomic<int> run_count{0};
+    std::vector<rapidrpc::TimerEvent::s_ptr> events;
+    for (int i = 0; i < 1000; i++) {
+        events.push_back(std::make_shared<rapidrpc::TimerEvent>(50, false, [&run_count]() { run_count++; }));
+        loop->addTimerEvent(events.back());
+    }
+    for (int i = 0; i < 1000; i += 2) {
+        loop->deleteTimerEvent(events[i]);
+    }
+    for (int i = 0; i < 100 && run_count < 500; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    loop->stop();
+    io_thread.join();
+
+    CHECK(run_count == 500);
+    for (int i = 0; i < 1000; i++) {
+        CHECK(!events[i]->isPending());
+        CHECK(events[i]->isCanceled() == (i % 2 == 0));
+    }
+    printf("test_timer_cross_thread success\n");
+}
+
+int main() {
+    rapidrpc::Config::SetGlobalConfig(nullptr);
+    rapidrpc::Config::GetGlobalConfig()->m_log_level = "ERROR";
+    rapidrpc::Logger::InitGlobalLogger();
+
+    // 每个线程一个 EventLoop
+    std::thread(test_timer_cancel, 0).join();
+    std::thread(test_timer_cancel, 5).join();
+    test_timer_cross_thread();
+
+    rapidrpc::Logger::GetGlobalLogger()->flushAndStop();
+    return 0;
+}
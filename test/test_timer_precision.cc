@@ -0,0 +1,130 @@
+/**
+ * 测试定时器精度: 定时任务使用单调时钟(us)，可以设置亚毫秒级的超时; 已经到达的任务立即执行;
+ * RpcController 超时时间的单位转换; EventLoop 每轮循环刷新的缓存时钟;
+ * 同一轮循环中执行了很久的任务之后创建的定时任务不会提前到达(新任务的到达时间读取实时时钟)
+ */
+
+#include "rapidrpc/net/eventloop.h"
+#include "rapidrpc/net/rpc/rpc_controller.h"
+#include "rapidrpc/common/log.h"
+#include "rapidrpc/common/config.h"
+#include "rapidrpc/common/util.h"
+#include "test_util.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include <thread>
+
+void test_rpc_controller_timeout() {
+    rapidrpc::RpcController controller;
+    CHECK(controller.GetTimeout() == 1000 && controller.GetTimeoutUs() == 1000000);
+    controller.SetTimeout(5000);
+    CHECK(controller.GetTimeout() == 5000 && controller.GetTimeoutUs() == 5000000);
+    controller.SetTimeout(std::chrono::microseconds(300));
+    CHECK(controller.GetTimeout() == 0 && controller.GetTimeoutUs() == 300);
+    controller.Reset();
+    CHECK(controller.GetTimeoutUs() == 1000000);
+    printf("test_rpc_controller_timeout success\n");
+}
+
+void test_timer_precision() {
+    rapidrpc::EventLoop *loop = rapidrpc::EventLoop::GetCurrentEventLoop();
+
+    // 300us, 800us 以及已经到达(0)的定时任务, 记录实际执行时间
+    std::vector<int64_t> intervals = {300, 800, 0};
+    std::vector<int64_t> run_at(intervals.size(), 0);
+    int64_t start = rapidrpc::getMonotonicUs();
+    for (size_t i = 0; i < intervals.size(); i++) {
+        int64_t *at = &run_at[i];
+        loop->addTimerEvent(std::make_shared<rapidrpc::TimerEvent>(std::chrono::microseconds(intervals[i]), false,
+                                                                   [at]() { *at = rapidrpc::getMonotonicUs(); }));
+    }
+    loop->addTimerEvent(std::make_shared<rapidrpc::TimerEvent>(20, false, [loop]() { loop->stop(); }));
+    loop->loop();
+
+    for (size_t i = 0; i < intervals.size(); i++) {
+        int64_t cost = run_at[i] - start;
+        printf("timer interval [%ldus], run after [%ldus]\n", intervals[i], cost);
+        CHECK(run_at[i] != 0);
+        CHECK(cost >= intervals[i]);
+        // 不会按毫秒取整或者延迟到下一个毫秒级的唤醒
+        CHECK(cost < intervals[i] + 5000);
+    }
+    CHECK(run_at[2] <= run_at[0] && run_at[0] <= run_at[1]);
+    printf("test_timer_precision success\n");
+}
+
+void test_cached_clock() {
+    // 没有运行 EventLoop 时读取实时时钟
+    int64_t before = rapidrpc::getMonotonicUs();
+    CHECK(rapidrpc::getCachedMonotonicUs() >= before);
+
+    rapidrpc::EventLoop *loop = rapidrpc::EventLoop::GetCurrentEventLoop();
+    int64_t cached[2] = {0, 0};
+    int64_t precise = 0;
+    int64_t now_us[2] = {0, 0};
+    loop->addTask(
+        [&]() {
+            cached[0] = rapidrpc::getCachedMonotonicUs();
+            now_us[0] = rapidrpc::getCachedNowUs();
+            // 同一轮循环中缓存的时间不变, 实时时钟继续增加
+            int64_t start = rapidrpc::getMonotonicUs();
+            while (rapidrpc::getMonotonicUs() - start < 1000)
+                ;
+            cached[1] = rapidrpc::getCachedMonotonicUs();
+            now_us[1] = rapidrpc::getCachedNowUs();
+            precise = rapidrpc::getMonotonicUs();
+            loop->stop();
+        },
+        true);
+    loop->loop();
+
+    CHECK(cached[0] >= before && cached[0] == cached[1]);
+    CHECK(now_us[0] == now_us[1] && now_us[0] / 1000 <= rapidrpc::getNowMs());
+    CHECK(precise - cached[1] >= 1000);
+    // 退出循环后读取实时时钟
+    CHECK(rapidrpc::getCachedMonotonicUs() >= precise);
+    printf("test_cached_clock success\n");
+}
+
+void test_timer_after_busy_task() {
+    rapidrpc::EventLoop *loop = rapidrpc::EventLoop::GetCurrentEventLoop();
+    int64_t created = 0;
+    int64_t run_at = 0;
+    loop->addTask(
+        [&]() {
+            // 本轮循环缓存的时间已经过去 50ms, 之后创建 20ms 的定时任务
+            int64_t start = rapidrpc::getMonotonicUs();
+            while (rapidrpc::getMonotonicUs() - start < 50000)
+                ;
+            created = rapidrpc::getMonotonicUs();
+            loop->addTimerEvent(std::make_shared<rapidrpc::TimerEvent>(20, false, [&]() {
+                run_at = rapidrpc::getMonotonicUs();
+                loop->stop();
+            }));
+        },
+        true);
+    loop->loop();
+
+    int64_t cost = run_at - created;
+    printf("timer created after busy task, interval [20000us], run after [%ldus]\n", cost);
+    CHECK(run_at != 0);
+    CHECK(cost >= 20000);
+    printf("test_timer_after_busy_task success\n");
+}
+
+int main() {
+    rapidrpc::Config::SetGlobalConfig(nullptr);
+    rapidrpc::Config::GetGlobalConfig()->m_log_level = "ERROR";
+    rapidrpc::Logger::InitGlobalLogger();
+
+    test_rpc_controller_timeout();
+    test_timer_precision();
+    // 新的线程(EventLoop), 上面的 EventLoop 已经停止
+    std::thread(test_cached_clock).join();
+    std::thread(test_timer_after_busy_task).join();
+
+    rapidrpc::Logger::GetGlobalLogger()->flushAndStop();
+    return 0;
+}
@@ -0,0 +1,110 @@
+/**
+ * 测试 timerfd 重新设置的合并: 同一轮中多次修改最早的到达时间只调用一次 timerfd_settime;
+ * 以及定时器 slack: 窗口内的到达时间共用一次唤醒, 定时任务不会提前执行
+ */
+
+#include "rapidrpc/net/eventloop.h"
+#include "rapidrpc/common/log.h"
+#include "rapidrpc/common/config.h"
+#include "rapidrpc/common/util.h"
+#include "test_util.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <vector>
+#include <thread>
+
+/**
+ * 在 EventLoop 中添加 count 个定时任务(到达时间递减, 每次都修改最早的到达时间), 全部执行后停止
+ * first_stats 为第一个定时任务执行时的统计, 此时只有添加时设置过 timerfd, 还没有到期后的重新设置
+ * @return 定时任务最大的提前执行时间(us), <= 0 表示没有提前执行
+ */
+int64_t run_timers(rapidrpc::EventLoop *loop, int count, int64_t first_us, int64_t step_us, int64_t &max_lag,
+                   rapidrpc::EventLoopStats &first_stats) {
+    std::vector<int64_t> arrive(count, 0);
+    std::vector<int64_t> run_at(count, 0);
+    int remain = count;
+    loop->addTask(
+        [&]() {
+            std::vector<rapidrpc::TimerEvent::s_ptr> events;
+            for (int i = 0; i < count; i++) {
+                std::chrono::microseconds interval(first_us + (count - 1 - i) * step_us);
+                auto event = std::make_shared<rapidrpc::TimerEvent>(interval, false, [&, i]() {
+                    run_at[i] = rapidrpc::getMonotonicUs();
+                    if (remain == count) {
+                        first_stats = loop->getStats();
+                    }
+                    if (--remain == 0) {
+                        loop->stop();
+                    }
+                });
+                arrive[i] = event->getArriveTime();
+                events.push_back(event);
+            }
+            // 到达时间在创建时读取实时时钟, 创建期间线程可能被调度出去; 按到达时间从晚到早添加
+            std::sort(events.begin(), events.end(), [](const rapidrpc::TimerEvent::s_ptr &a,
+                                                       const rapidrpc::TimerEvent::s_ptr &b) {
+                return a->getArriveTime() > b->getArriveTime();
+            });
+            for (auto &event : events) {
+                loop->addTimerEvent(event);
+            }
+        },
+        true);
+    loop->loop();
+
+    int64_t max_early = INT64_MIN;
+    max_lag = 0;
+    for (int i = 0; i < count; i++) {
+        max_early = std::max(max_early, arrive[i] - run_at[i]);
+        max_lag = std::max(max_lag, run_at[i] - arrive[i]);
+    }
+    return max_early;
+}
+
+void test_settime_coalescing() {
+    rapidrpc::EventLoop *loop = rapidrpc::EventLoop::GetCurrentEventLoop();
+    int64_t max_lag = 0;
+    rapidrpc::EventLoopStats first;
+    // 1000 个到达时间间隔 50us 的定时任务，同一轮中添加
+    CHECK(run_timers(loop, 1000, 20000, 50, max_lag, first) <= 0);
+
+    rapidrpc::EventLoopStats stats = loop->getStats();
+    printf("test_settime_coalescing: add settime [%lu], saved [%lu]; total settime [%lu], max lag [%ldus]\n",
+           first.m_timer_settime, first.m_timer_settime_saved, stats.m_timer_settime, max_lag);
+    // 原来每次修改最早的到达时间都调用一次, 现在同一轮中添加只调用一次
+    // 之后到期的重新设置次数取决于每次唤醒时已经到达的任务数, 不检查
+    CHECK(first.m_timer_settime == 1);
+    CHECK(first.m_timer_settime_saved >= 999);
+    printf("test_settime_coalescing success\n");
+}
+
+void test_timer_slack() {
+    rapidrpc::EventLoop *loop = rapidrpc::EventLoop::GetCurrentEventLoop();
+    loop->setTimerSlack(5000);
+    int64_t max_lag = 0;
+    rapidrpc::EventLoopStats first;
+    // 50 个定时任务, 间隔 200us, 跨越 10ms: 最多 3 个 5ms 的窗口
+    CHECK(run_timers(loop, 50, 10000, 200, max_lag, first) <= 0);
+
+    rapidrpc::EventLoopStats stats = loop->getStats();
+    printf("test_timer_slack: settime [%lu], saved [%lu], max lag [%ldus]\n", stats.m_timer_settime,
+           stats.m_timer_settime_saved, max_lag);
+    CHECK(stats.m_timer_settime <= 5);
+    CHECK(max_lag < 5000 + 5000);
+    printf("test_timer_slack success\n");
+}
+
+int main() {
+    rapidrpc::Config::SetGlobalConfig(nullptr);
+    rapidrpc::Config::GetGlobalConfig()->m_log_level = "ERROR";
+    rapidrpc::Logger::InitGlobalLogger();
+
+    // 每个线程一个 EventLoop
+    std::thread(test_settime_coalescing).join();
+    std::thread(test_timer_slack).join();
+
+    rapidrpc::Logger::GetGlobalLogger()->flushAndStop();
+    return 0;
+}
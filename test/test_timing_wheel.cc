@@ -0,0 +1,130 @@
+/**
+ * 测试分层时间轮: 定时任务不会提前/重复执行，删除后不执行，跨层(cascade)后仍然准确；
+ * 以及 EventLoop 使用时间轮时定时任务的执行
+ */
+
+#include "rapidrpc/net/timing_wheel.h"
+#include "rapidrpc/net/eventloop.h"
+#include "rapidrpc/common/log.h"
+#include "rapidrpc/common/config.h"
+#include "rapidrpc/common/util.h"
+#include "test_util.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include <unordered_set>
+
+/**
+ * 随机的到达时间(覆盖所有层)，随机步长转动时间轮, 时间单位 us
+ * tick_us = 1 时，定时任务在第一次 now >= arrive_time 的 advance 中到期;
+ * tick_us > 1 时，最多延迟一个 tick
+ */
+void test_wheel(int64_t tick_us, int count, int64_t max_interval) {
+    int64_t start = rapidrpc::getMonotonicUs();
+    rapidrpc::TimingWheel wheel(tick_us, start);
+
+    std::vector<rapidrpc::TimerEvent::s_ptr> events;
+    for (int i = 0; i < count; i++) {
+        std::chrono::microseconds interval(random() % max_interval);
+        events.push_back(std::make_shared<rapidrpc::TimerEvent>(interval, false, nullptr));
+        wheel.add(events.back());
+    }
+    // 重复添加会重新放置，不会重复执行
+    wheel.add(events[0]);
+    CHECK(wheel.size() == static_cast<size_t>(count));
+
+    // 删除一半
+    std::unordered_set<rapidrpc::TimerEvent *> removed;
+    for (int i = 0; i < count; i += 2) {
+        CHECK(wheel.remove(events[i]));
+        CHECK(!wheel.remove(events[i]));
+        removed.insert(events[i].get());
+    }
+    CHECK(wheel.size() == static_cast<size_t>(count - removed.size()));
+
+    int64_t end = start + max_interval + 2 * tick_us + 1000000;
+    int64_t prev_now = start - 1;
+    int64_t now = start;
+    size_t expired_count = 0;
+    std::vector<rapidrpc::TimerEvent::s_ptr> expired;
+    while (now <= end) {
+        expired.clear();
+        wheel.advance(now, expired);
+        for (auto &event : expired) {
+            CHECK(removed.find(event.get()) == removed.end());
+            // 不会提前执行
+            CHECK(event->getArriveTime() <= now);
+            // 最多延迟一个 tick(tick_us = 1 时不延迟)
+            CHECK(event->getArriveTime() > prev_now - tick_us);
+            if (tick_us == 1) {
+                CHECK(event->getArriveTime() > prev_now);
+            }
+        }
+        expired_count += expired.size();
+        prev_now = now;
+        now += 1 + random() % 50000;
+    }
+    CHECK(expired_count == count - removed.size());
+    CHECK(wheel.size() == 0);
+    printf("test_wheel success, tick [%ldus], timers [%d], max interval [%ldus]\n", tick_us, count, max_interval);
+}
+
+// 超出时间轮范围的定时任务放在最高层，转动时重新放置
+void test_wheel_overflow() {
+    int64_t start = rapidrpc::getMonotonicUs();
+    rapidrpc::TimingWheel wheel(1000, start);
+    std::chrono::milliseconds interval(rapidrpc::TimingWheel::MAX_TICKS + 12345);
+    auto event = std::make_shared<rapidrpc::TimerEvent>(interval, false, nullptr);
+    wheel.add(event);
+
+    std::vector<rapidrpc::TimerEvent::s_ptr> expired;
+    int64_t now = start;
+    while (expired.empty()) {
+        now += 1000000;
+        wheel.advance(now, expired);
+    }
+    CHECK(expired[0] == event);
+    CHECK(now >= event->getArriveTime() && now - event->getArriveTime() < 1000000);
+    printf("test_wheel_overflow success\n");
+}
+
+// EventLoop 使用时间轮，重复任务和取消
+void test_eventloop_timing_wheel() {
+    rapidrpc::EventLoop *loop = rapidrpc::EventLoop::GetCurrentEventLoop();
+    loop->setTimingWheel(5);
+
+    int repeat_count = 0;
+    bool canceled_run = false;
+    int64_t start = rapidrpc::getNowMs();
+    auto repeat = std::make_shared<rapidrpc::TimerEvent>(10, true, [&repeat_count]() { repeat_count++; });
+    auto canceled = std::make_shared<rapidrpc::TimerEvent>(20, false, [&canceled_run]() { canceled_run = true; });
+    auto stop = std::make_shared<rapidrpc::TimerEvent>(105, false, [loop]() { loop->stop(); });
+    loop->addTimerEvent(repeat);
+    loop->addTimerEvent(canceled);
+    loop->addTimerEvent(stop);
+    loop->deleteTimerEvent(canceled);
+    loop->loop();
+
+    int64_t cost = rapidrpc::getNowMs() - start;
+    printf("test_eventloop_timing_wheel: repeat count [%d], cost [%ldms]\n", repeat_count, cost);
+    CHECK(!canceled_run);
+    CHECK(repeat_count >= 5 && repeat_count <= 10);
+    CHECK(cost >= 105 && cost < 200);
+    printf("test_eventloop_timing_wheel success\n");
+}
+
+int main() {
+    rapidrpc::Config::SetGlobalConfig(nullptr);
+    rapidrpc::Config::GetGlobalConfig()->m_log_level = "ERROR";
+    rapidrpc::Logger::InitGlobalLogger();
+
+    srandom(12345);
+    test_wheel(1000, 100000, 300000000);
+    test_wheel(10000, 100000, 3000000000);
+    test_wheel_overflow();
+    test_eventloop_timing_wheel();
+
+    rapidrpc::Logger::GetGlobalLogger()->flushAndStop();
+    return 0;
+}
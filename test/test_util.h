@@ -0,0 +1,133 @@
+/**
+ * @file test_util.h
+ * 测试程序共用的工具:
+ * 1. CHECK 断言: 条件不成立时打印条件和行号并退出(返回 -1)
+ * 2. 通过原始 socket 调用 Order.makeOrder 的客户端: 连接、发送请求、按顺序读取响应;
+ *    Order 服务的实现和检查由各个测试程序自己提供
+ */
+
+#ifndef RAPIDRPC_TEST_TEST_UTIL_H
+#define RAPIDRPC_TEST_TEST_UTIL_H
+
+#include "rapidrpc/net/tcp/tcp_buffer.h"
+#include "rapidrpc/net/coder/tinypb_coder.h"
+#include "rapidrpc/net/coder/tinypb_protocol.h"
+#include "order.pb.h"
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#define CHECK(cond)                                                                                                    \
+    if (!(cond)) {                                                                                                     \
+        printf("CHECK failed: %s, line %d\n", #cond, __LINE__);                                                       \
+        exit(-1);                                                                                                      \
+    }
+
+/**
+ * @brief 阻塞连接 127.0.0.1:port
+ */
+inline int connect_server(int port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    CHECK(fd >= 0);
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    inet_aton("127.0.0.1", &addr.sin_addr);
+    CHECK(connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0);
+    return fd;
+}
+
+/**
+ * @brief 构造 Order.makeOrder 请求, msg_id 为 id
+ */
+inline rapidrpc::AbstractProtocol::s_ptr make_request(int id, const makeOrderRequest &request) {
+    std::string pb_data;
+    request.SerializeToString(&pb_data);
+    auto message = std::make_shared<rapidrpc::TinyPBProtocol>();
+    message->setMsgId(std::to_string(id)).setMethodName("Order.makeOrder").setPbData(pb_data).complete();
+    return message;
+}
+
+/**
+ * @brief 编码并发送全部请求, 直到写完
+ */
+inline void send_messages(int fd, std::vector<rapidrpc::AbstractProtocol::s_ptr> &messages) {
+    rapidrpc::TinyPBCoder coder;
+    auto buffer = std::make_shared<rapidrpc::TcpBuffer>(1024);
+    coder.encode(messages, buffer);
+    const char *data = &buffer->m_buffer[buffer->readIndex()];
+    int len = buffer->readAvailable();
+    while (len > 0) {
+        int n = write(fd, data, len);
+        CHECK(n > 0);
+        data += n;
+        len -= n;
+    }
+}
+
+/**
+ * @brief 发送一个 price 为 price 的请求, 不等待响应
+ */
+inline void send_request(int fd, int id, int price) {
+    makeOrderRequest request;
+    request.set_price(price);
+    std::vector<rapidrpc::AbstractProtocol::s_ptr> messages{make_request(id, request)};
+    send_messages(fd, messages);
+}
+
+/**
+ * @brief 按顺序逐个读取响应, 一次 read 可能包含多个响应
+ */
+class ResponseReader {
+public:
+    explicit ResponseReader(int fd)
+        : m_fd(fd), m_in_buffer(std::make_shared<rapidrpc::TcpBuffer>(1024)), m_read_buf(64 * 1024) {}
+
+    std::shared_ptr<rapidrpc::TinyPBProtocol> next() {
+        while (m_pending.empty()) {
+            int n = read(m_fd, m_read_buf.data(), m_read_buf.size());
+            CHECK(n > 0);
+            m_in_buffer->writeToBuffer(m_read_buf.data(), n);
+            std::vector<rapidrpc::AbstractProtocol::s_ptr> messages;
+            m_coder.decode(messages, m_in_buffer);
+            m_pending.insert(m_pending.end(), messages.begin(), messages.end());
+        }
+        auto message = m_pending.front();
+        m_pending.pop_front();
+        return std::dynamic_pointer_cast<rapidrpc::TinyPBProtocol>(message);
+    }
+
+private:
+    int m_fd;
+    rapidrpc::TinyPBCoder m_coder;
+    rapidrpc::TcpBuffer::s_ptr m_in_buffer;
+    std::vector<char> m_read_buf;
+    std::deque<rapidrpc::AbstractProtocol::s_ptr> m_pending;
+};
+
+/**
+ * @brief 发送一个 price 为 id 的请求并等待响应, 检查 err_code 和 msg_id
+ * @return 解析后的响应
+ */
+inline makeOrderResponse call(int fd, int id) {
+    send_request(fd, id, id);
+    ResponseReader reader(fd);
+    auto resp = reader.next();
+    CHECK(resp->m_err_code == 0);
+    CHECK(resp->m_msg_id == std::to_string(id));
+    makeOrderResponse response;
+    CHECK(response.ParseFromString(resp->m_pb_data));
+    return response;
+}
+
+#endif // RAPIDRPC_TEST_TEST_UTIL_H
@@ -0,0 +1,227 @@
+/**
+ * 测试工作窃取线程池:
+ * 1. ChaseLevDeque 所有者 push/take 与多个窃取者并发，每个元素恰好取出一次(包括扩容)
+ * 2. WorkStealingPool 执行所有任务，有界队列拒绝，stop 执行完剩余的任务
+ * 3. 一个业务线程被耗时的任务阻塞时，分配给它的任务被其他线程窃取执行
+ * 4. 业务线程中提交的任务(嵌套)
+ * 5. 线程池释放后在同一个地址创建业务线程更少的线程池，外部线程记录的业务线程不再使用
+ */
+
+#include "rapidrpc/common/log.h"
+#include "rapidrpc/common/config.h"
+#include "rapidrpc/common/chase_lev_deque.h"
+#include "rapidrpc/common/work_stealing_pool.h"
+#include "test_util.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+void test_deque() {
+    const int count = 200000;
+    std::vector<int> items(count);
+    std::vector<std::atomic<int>> taken(count);
+    for (int i = 0; i < count; i++) {
+        items[i] = i;
+        taken[i] = 0;
+    }
+
+    rapidrpc::ChaseLevDeque<int> deque(4);
+    std::atomic<bool> done{false};
+    std::atomic<int> stolen{0};
+    std::vector<std::thread> thieves;
+    for (int i = 0; i < 3; i++) {
+        thieves.emplace_back([&]() {
+            while (!done.load() || !deque.empty()) {
+                int *item = deque.steal();
+                if (item) {
+                    taken[*item]++;
+                    stolen++;
+                }
+            }
+        });
+    }
+
+    // 所有者每 push 3 个 take 1 个
+    for (int i = 0; i < count; i++) {
+        deque.push(&items[i]);
+        if (i % 3 == 2) {
+            int *item = deque.take();
+            if (item) {
+                taken[*item]++;
+            }
+        }
+    }
+    int *item = nullptr;
+    while ((item = deque.take()) != nullptr) {
+        taken[*item]++;
+    }
+    done = true;
+    for (auto &t : thieves) {
+        t.join();
+    }
+    for (int i = 0; i < count; i++) {
+        CHECK(taken[i] == 1);
+    }
+    printf("test_deque success, stolen [%d] of [%d]\n", stolen.load(), count);
+}
+
+void test_execute_all() {
+    std::atomic<int> done{0};
+    rapidrpc::WorkStealingPool pool(4, 0);
+    CHECK(pool.getThreadCount() == 4);
+    std::vector<std::thread> submitters;
+    for (int i = 0; i < 3; i++) {
+        submitters.emplace_back([&]() {
+            for (int j = 0; j < 10000; j++) {
+                CHECK(pool.submit([&]() { done++; }));
+            }
+        });
+    }
+    for (auto &t : submitters) {
+        t.join();
+    }
+    // stop 执行完剩余的任务
+    pool.stop();
+    CHECK(done == 30000);
+    CHECK(pool.getQueueSize() == 0);
+    CHECK(!pool.submit([&]() { done++; }));
+    printf("test_execute_all success, stolen [%lu]\n", pool.getStolen());
+}
+
+void test_bounded_queue() {
+    std::atomic<int> done{0};
+    std::atomic<bool> release{false};
+    rapidrpc::WorkStealingPool pool(2, 4);
+    auto block = [&]() {
+        while (!release.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        done++;
+    };
+    CHECK(pool.submit(block));
+    CHECK(pool.submit(block));
+    // 两个业务线程都已经取出任务并阻塞
+    while (pool.getQueueSize() != 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    for (int i = 0; i < 4; i++) {
+        CHECK(pool.submit([&]() { done++; }));
+    }
+    CHECK(!pool.submit([&]() { done++; }));
+    CHECK(pool.getRejected() == 1);
+    CHECK(pool.getQueueSize() == 4);
+
+    release = true;
+    pool.stop();
+    CHECK(done == 6);
+    printf("test_bounded_queue success\n");
+}
+
+// 同一个外部线程提交的任务都放入同一个业务线程, 它被阻塞时其他线程窃取
+void test_steal_from_blocked() {
+    std::atomic<int> done{0};
+    std::atomic<bool> release{false};
+    std::mutex mutex;
+    std::set<std::string> names;
+    rapidrpc::WorkStealingPool pool(4, 0);
+
+    CHECK(pool.submit([&]() {
+        while (!release.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }));
+    for (int i = 0; i < 100; i++) {
+        CHECK(pool.submit([&]() {
+            char name[16] = {0};
+            pthread_getname_np(pthread_self(), name, sizeof(name));
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                names.insert(name);
+            }
+            done++;
+        }));
+    }
+
+    // 耗时的任务没有结束, 其余任务已经被执行
+    auto begin = std::chrono::steady_clock::now();
+    while (done != 100) {
+        CHECK(std::chrono::steady_clock::now() - begin < std::chrono::seconds(5));
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    CHECK(pool.getStolen() > 0);
+    for (auto &name : names) {
+        CHECK(name.compare(0, 13, "rapidrpc-work") == 0);
+    }
+    release = true;
+    pool.stop();
+    printf("test_steal_from_blocked success, threads used [%zu], stolen [%lu]\n", names.size(), pool.getStolen());
+}
+
+// 每个任务再提交两个子任务, 共 2^depth - 1 个任务
+void spawn(rapidrpc::WorkStealingPool &pool, std::atomic<int> &done, int depth) {
+    done++;
+    if (depth > 1) {
+        CHECK(pool.submit([&pool, &done, depth]() { spawn(pool, done, depth - 1); }));
+        CHECK(pool.submit([&pool, &done, depth]() { spawn(pool, done, depth - 1); }));
+    }
+}
+
+void test_nested_submit() {
+    std::atomic<int> done{0};
+    rapidrpc::WorkStealingPool pool(4, 0);
+    CHECK(pool.submit([&]() { spawn(pool, done, 14); }));
+    auto begin = std::chrono::steady_clock::now();
+    while (done != (1 << 14) - 1) {
+        CHECK(std::chrono::steady_clock::now() - begin < std::chrono::seconds(10));
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    pool.stop();
+    CHECK(done == (1 << 14) - 1);
+    printf("test_nested_submit success, stolen [%lu]\n", pool.getStolen());
+}
+
+void test_reused_address() {
+    std::set<void *> addresses;
+    for (int round = 0; round < 10; round++) {
+        std::atomic<int> done{0};
+        // 其他线程先提交, 主线程固定放入最后一个业务线程
+        rapidrpc::WorkStealingPool *pool = new rapidrpc::WorkStealingPool(4, 0);
+        for (int i = 0; i < 3; i++) {
+            std::thread([&]() { CHECK(pool->submit([&]() { done++; })); }).join();
+        }
+        CHECK(pool->submit([&]() { done++; }));
+        delete pool;
+        CHECK(done == 4);
+        addresses.insert(pool);
+
+        // 释放后的地址通常被下一个线程池复用
+        rapidrpc::WorkStealingPool *small = new rapidrpc::WorkStealingPool(1, 0);
+        addresses.insert(small);
+        CHECK(small->submit([&]() { done++; }));
+        delete small;
+        CHECK(done == 5);
+    }
+    printf("test_reused_address success, distinct addresses [%zu]\n", addresses.size());
+}
+
+int main() {
+    rapidrpc::Config::SetGlobalConfig(nullptr);
+    rapidrpc::Config::GetGlobalConfig()->m_log_level = "ERROR";
+    rapidrpc::Logger::InitGlobalLogger();
+
+    test_deque();
+    test_execute_all();
+    test_bounded_queue();
+    test_steal_from_blocked();
+    test_nested_submit();
+    test_reused_address();
+    return 0;
+}
@@ -0,0 +1,177 @@
+/**
+ * 测试业务线程池:
+ * 1. WorkerPool 有界队列，队列已满时 submit 返回 false; stop 执行完剩余的任务
+ * 2. 设置为 pooled 的服务在业务线程中执行，阻塞的服务不会阻塞 IO 线程; 队列已满时返回 SYS_SERVER_BUSY
+ */
+
+#include "rapidrpc/common/log.h"
+#include "rapidrpc/common/config.h"
+#include "rapidrpc/common/error_code.h"
+#include "rapidrpc/common/worker_pool.h"
+#include "rapidrpc/net/tcp/net_addr.h"
+#include "rapidrpc/net/tcp/tcp_server.h"
+#include "rapidrpc/net/coder/tinypb_protocol.h"
+#include "rapidrpc/net/rpc/dispatcher.h"
+#include "order.pb.h"
+#include "test_util.h"
+
+#include <google/protobuf/service.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <chrono>
+#include <vector>
+
+static const char *g_server_addr = "127.0.0.1:12348";
+
+// 模拟阻塞的服务(例如访问数据库)，响应中带回执行服务的线程名称
+class OrderImpl: public Order {
+public:
+    void makeOrder(google::protobuf::RpcController *controller, const ::makeOrderRequest *request,
+                   ::makeOrderResponse *response, google::protobuf::Closure *done) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(request->price()));
+        char name[16] = {0};
+        pthread_getname_np(pthread_self(), name, sizeof(name));
+        response->set_ret_code(0);
+        response->set_res_info(name);
+        response->set_order_id(request->goods());
+    }
+};
+
+void test_bounded_queue() {
+    std::atomic<int> done{0};
+    std::atomic<bool> release{false};
+    rapidrpc::WorkerPool pool(1, 2);
+    CHECK(pool.getThreadCount() == 1);
+
+    // 第一个任务阻塞唯一的线程, 之后队列最多容纳 2 个任务
+    CHECK(pool.submit([&]() {
+        while (!release.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        done++;
+    }));
+    while (pool.getQueueSize() != 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    CHECK(pool.submit([&]() { done++; }));
+    CHECK(pool.submit([&]() { done++; }));
+    CHECK(!pool.submit([&]() { done++; }));
+    CHECK(pool.getRejected() == 1);
+    CHECK(pool.getQueueSize() == 2);
+
+    // stop 执行完队列中剩余的任务
+    release = true;
+    pool.stop();
+    CHECK(done == 3);
+    CHECK(!pool.submit([&]() { done++; }));
+    printf("test_bounded_queue success\n");
+}
+
+void test_worker_threads() {
+    std::mutex mutex;
+    std::set<std::string> names;
+    rapidrpc::WorkerPool pool(3, 0);
+    for (int i = 0; i < 300; i++) {
+        CHECK(pool.submit([&]() {
+            char name[16] = {0};
+            pthread_getname_np(pthread_self(), name, sizeof(name));
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+            std::lock_guard<std::mutex> lock(mutex);
+            names.insert(name);
+        }));
+    }
+    pool.stop();
+    CHECK(names.size() >= 1 && names.size() <= 3);
+    for (auto &name : names) {
+        CHECK(name.compare(0, 13, "rapidrpc-work") == 0);
+    }
+    printf("test_worker_threads success, threads used [%zu]\n", names.size());
+}
+
+// 一次发送 count 个阻塞 sleep_ms 的请求, goods 和 msg_id 为请求序号
+void send_requests(int fd, int count, int sleep_ms) {
+    std::vector<rapidrpc::AbstractProtocol::s_ptr> messages;
+    for (int i = 0; i < count; i++) {
+        makeOrderRequest request;
+        request.set_price(sleep_ms);
+        request.set_goods(std::to_string(i));
+        messages.push_back(make_request(i, request));
+    }
+    send_messages(fd, messages);
+}
+
+// 1 个业务线程, 队列长度 2: 一次发送 8 个阻塞 100ms 的请求，超出队列的请求立即返回 SYS_SERVER_BUSY,
+// 不会等待阻塞的服务执行完
+void test_pooled_service() {
+    auto dispatcher = rapidrpc::Dispatcher::GetDispatcher();
+    auto probe = std::make_shared<rapidrpc::TinyPBProtocol>();
+    probe->setMethodName("Order.makeOrder");
+    CHECK(dispatcher->isPooled(probe));
+    probe->setMethodName("Other.makeOrder");
+    CHECK(!dispatcher->isPooled(probe));
+
+    int fd = connect_server(12348);
+    auto begin = std::chrono::steady_clock::now();
+    send_requests(fd, 8, 100);
+
+    ResponseReader reader(fd);
+    int accepted = 0;
+    int rejected = 0;
+    while (accepted + rejected < 8) {
+        auto resp = reader.next();
+        auto elapsed = std::chrono::steady_clock::now() - begin;
+        if (resp->m_err_code == static_cast<int32_t>(rapidrpc::Error::SYS_SERVER_BUSY)) {
+            // IO 线程没有被阻塞，第一个请求执行完之前已经返回
+            CHECK(accepted == 0);
+            CHECK(elapsed < std::chrono::milliseconds(100));
+            rejected++;
+            continue;
+        }
+        CHECK(resp->m_err_code == 0);
+        makeOrderResponse response;
+        CHECK(response.ParseFromString(resp->m_pb_data));
+        CHECK(response.order_id() == resp->m_msg_id);
+        CHECK(response.res_info() == "rapidrpc-work-0");
+        accepted++;
+    }
+    // 一个请求正在执行(或者还在队列中) + 队列中的 2 个请求
+    CHECK(accepted == 2 || accepted == 3);
+    CHECK(dispatcher->getWorkerPool()->getRejected() == static_cast<uint64_t>(rejected));
+    close(fd);
+    // 等待业务线程执行完剩余的请求再退出进程, 否则退出时全局对象已经析构, IO 线程还在处理响应和关闭连接
+    while (dispatcher->getWorkerPool()->getQueueSize() > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    printf("test_pooled_service success, accepted [%d], rejected [%d]\n", accepted, rejected);
+}
+
+int main() {
+    rapidrpc::Config::SetGlobalConfig(nullptr);
+    rapidrpc::Config::GetGlobalConfig()->m_log_level = "ERROR";
+    rapidrpc::Config::GetGlobalConfig()->m_io_threads = 1;
+    rapidrpc::Config::GetGlobalConfig()->m_worker_threads = 1;
+    rapidrpc::Config::GetGlobalConfig()->m_worker_queue_size = 2;
+    rapidrpc::Config::GetGlobalConfig()->m_pooled_services = "Order";
+    rapidrpc::Logger::InitGlobalLogger();
+
+    test_bounded_queue();
+    test_worker_threads();
+
+    rapidrpc::Dispatcher::GetDispatcher()->registerService(std::make_shared<OrderImpl>());
+    std::thread server([]() {
+        rapidrpc::TcpServer tcp_server(std::make_shared<rapidrpc::IpNetAddr>(g_server_addr));
+        tcp_server.start();
+    });
+    server.detach();
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    test_pooled_service();
+    return 0;
+}